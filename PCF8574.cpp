@@ -2,7 +2,7 @@
 //    FILE: PCF8574.cpp
 //  AUTHOR: Rob Tillaart
 //    DATE: 02-febr-2013
-// VERSION: 0.4.1
+// VERSION: 0.5.0
 // PURPOSE: Arduino library for PCF8574 - 8 channel I2C IO expander
 //     URL: https://github.com/RobTillaart/PCF8574
 //          http://forum.arduino.cc/index.php?topic=184800
@@ -11,14 +11,68 @@
 #include "PCF8574.h"
 
 
-PCF8574::PCF8574(const uint8_t deviceAddress, TwoWire *wire)
-: _address {deviceAddress}, _wire {wire}
-{}
+//  read8(), write8(), write() and toggleMask()
+#ifndef PCF8574_HEADER_ONLY
+#define PCF8574_INLINE
+#include "PCF8574_hot.h"
+#endif
+
+
+#ifdef PCF8574_RETAIN
+#define PCF8574_RETAIN_MAGIC        0x8574
+#endif
+
+
+uint16_t PCF8574_crc16(const uint8_t * data, const uint8_t length)
+{
+  uint16_t crc = 0xFFFF;
+  for (uint8_t i = 0; i < length; i++)
+  {
+    crc ^= data[i];
+    for (uint8_t b = 0; b < 8; b++)
+    {
+      if (crc & 0x0001) crc = (crc >> 1) ^ 0xA001;
+      else crc >>= 1;
+    }
+  }
+  return crc;
+}
+
+
+#ifdef PCF8574_RETAIN
+//  CRC over the fields, not the struct, so padding does not matter.
+static uint16_t PCF8574_retainCRC(const PCF8574_Retain * r)
+{
+  uint8_t data[5] = { (uint8_t)(r->magic & 0xFF), (uint8_t)(r->magic >> 8),
+                      r->address, r->dataOut, r->buttonMask };
+  return PCF8574_crc16(data, 5);
+}
+#endif
 
 
 bool PCF8574::begin(uint8_t value)
 {
   if (! isConnected()) return false;
+
+#ifdef PCF8574_RETAIN
+  _warmStart = (_retain != nullptr)
+            && (_retain->magic == PCF8574_RETAIN_MAGIC)
+            && (_retain->address == _address)
+            && (_retain->crc == PCF8574_retainCRC(_retain));
+  if (_warmStart)
+  {
+    _dataOut = _retain->dataOut;
+    _buttonMask = _retain->buttonMask;
+    //  one read to verify the outputs survived.
+    _error = PCF8574_OK;
+    PCF8574::read8();
+    _retainActive = true;
+    if ((_error == PCF8574_OK) && isOutputValid()) return true;
+    value = _dataOut;
+  }
+  //  retain is only updated after begin(), not to overwrite a warm state.
+  _retainActive = (_retain != nullptr);
+#endif
   PCF8574::write8(value);
   return true;
 }
@@ -26,8 +80,26 @@ bool PCF8574::begin(uint8_t value)
 
 bool PCF8574::isConnected()
 {
-  _wire->beginTransmission(_address);
-  return ( _wire->endTransmission() == 0);
+#ifdef PCF8574_CALLSTATS
+  uint32_t start = 0;
+  if (_stats != nullptr) start = PCF8574_micros();
+#endif
+  bool rv = false;
+#ifdef PCF8574_SIM
+  if (_sim != nullptr)
+  {
+    rv = (_sim->write(_address, nullptr, 0) == 0);
+  }
+  else
+#endif
+  {
+    _wire->beginTransmission(_address);
+    rv = (_wire->endTransmission() == 0);
+  }
+#ifdef PCF8574_CALLSTATS
+  if (_stats != nullptr) _stats->record(PCF8574_micros() - start);
+#endif
+  return rv;
 }
 
 bool PCF8574::setAddress(const uint8_t deviceAddress)
@@ -36,29 +108,48 @@ bool PCF8574::setAddress(const uint8_t deviceAddress)
   return isConnected();
 }
 
-//  removed _wire->beginTransmission(_address);
-//  with    @100 KHz -> 265 micros()
-//  without @100 KHz -> 132 micros()
-//  without @400 KHz -> 52 micros()
-//  TODO    @800 KHz -> ??
-uint8_t PCF8574::read8()
+
+void PCF8574::writeArray(const uint8_t * values, const uint8_t count)
 {
-  if (_wire->requestFrom(_address, (uint8_t)1) != 1)
+  if (count == 0) return;
+#ifdef PCF8574_INTERLOCK
+  if (_interlock != nullptr)
   {
-    _error = PCF8574_I2C_ERROR;
-    return _dataIn;  //  last value
+    for (uint8_t i = 0; i < count; i++)
+    {
+      if (_interlock->check(values[i])) continue;
+      _error = PCF8574_INTERLOCK_ERROR;  //  block whole array
+      PCF8574_TRACE2(error, _address, _error);
+      return;
+    }
   }
-  _dataIn = _wire->read();
-  return _dataIn;
-}
-
-
-void PCF8574::write8(const uint8_t value)
-{
-  _dataOut = value;
-  _wire->beginTransmission(_address);
-  _wire->write(_dataOut);
-  _error = _wire->endTransmission();
+#endif
+#ifdef PCF8574_CALLSTATS
+  uint32_t start = 0;
+  if (_stats != nullptr) start = PCF8574_micros();
+#endif
+  _dataOut = values[count - 1];
+  PCF8574_TRACE2(write_start, _address, _dataOut);
+#ifdef PCF8574_SIM
+  if (_sim != nullptr)
+  {
+    _error = _sim->write(_address, values, count);
+  }
+  else
+#endif
+  {
+    _wire->beginTransmission(_address);
+    _wire->write(values, count);
+    _error = _wire->endTransmission();
+  }
+#ifdef PCF8574_RETAIN
+  if (_retainActive) _updateRetain();
+#endif
+  if (_error != 0) PCF8574_TRACE2(error, _address, _error);
+  PCF8574_TRACE2(write_end, _address, _error);
+#ifdef PCF8574_CALLSTATS
+  if (_stats != nullptr) _stats->record(PCF8574_micros() - start);
+#endif
 }
 
 
@@ -74,25 +165,6 @@ uint8_t PCF8574::read(const uint8_t pin)
 }
 
 
-void PCF8574::write(const uint8_t pin, const uint8_t value)
-{
-  if (pin > 7)
-  {
-    _error = PCF8574_PIN_ERROR;
-    return;
-  }
-  if (value == LOW)
-  {
-    _dataOut &= ~(1 << pin);
-  }
-  else
-  {
-    _dataOut |= (1 << pin);
-  }
-  write8(_dataOut);
-}
-
-
 void PCF8574::toggle(const uint8_t pin)
 {
   if (pin > 7)
@@ -104,28 +176,30 @@ void PCF8574::toggle(const uint8_t pin)
 }
 
 
-void PCF8574::toggleMask(const uint8_t mask)
+void PCF8574::shiftRight(const uint8_t n)
 {
-  _dataOut ^= mask;
-  PCF8574::write8(_dataOut);
+  if ((n == 0) || (_dataOut == 0)) return;
+  uint8_t value = 0;                   //  shift 8++ clears all, valid...
+  if (n < 8) value = _dataOut >> n;
+  PCF8574::write8(value);
 }
 
 
-void PCF8574::shiftRight(const uint8_t n)
+void PCF8574::shiftLeft(const uint8_t n)
 {
   if ((n == 0) || (_dataOut == 0)) return;
-  if (n > 7)         _dataOut = 0;     //  shift 8++ clears all, valid...
-  if (_dataOut != 0) _dataOut >>= n;   //  only shift if there are bits set
-  PCF8574::write8(_dataOut);
+  uint8_t value = 0;                  //  shift 8++ clears all, valid...
+  if (n < 8) value = _dataOut << n;
+  PCF8574::write8(value);
 }
 
 
-void PCF8574::shiftLeft(const uint8_t n)
+void PCF8574::setButtonMask(const uint8_t mask)
 {
-  if ((n == 0) || (_dataOut == 0)) return;
-  if (n > 7)         _dataOut = 0;    //  shift 8++ clears all, valid...
-  if (_dataOut != 0) _dataOut <<= n;  //  only shift if there are bits set
-  PCF8574::write8(_dataOut);
+  _buttonMask = mask;
+#ifdef PCF8574_RETAIN
+  if (_retainActive) _updateRetain();
+#endif
 }
 
 
@@ -141,8 +215,7 @@ void PCF8574::rotateRight(const uint8_t n)
 {
   uint8_t r = n & 7;
   if (r == 0) return;
-  _dataOut = (_dataOut >> r) | (_dataOut << (8 - r));
-  PCF8574::write8(_dataOut);
+  PCF8574::write8((_dataOut >> r) | (_dataOut << (8 - r)));
 }
 
 
@@ -206,5 +279,21 @@ void PCF8574::selectN(const uint8_t pin)
 };
 
 
+/////////////////////////////////////////////////////////////
+//
+//  PRIVATE
+//
+#ifdef PCF8574_RETAIN
+void PCF8574::_updateRetain()
+{
+  _retain->address    = _address;
+  _retain->dataOut    = _dataOut;
+  _retain->buttonMask = _buttonMask;
+  _retain->magic      = PCF8574_RETAIN_MAGIC;
+  _retain->crc        = PCF8574_retainCRC(_retain);
+}
+#endif
+
+
 //  -- END OF FILE --
 
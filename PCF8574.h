@@ -3,7 +3,7 @@
 //    FILE: PCF8574.h
 //  AUTHOR: Rob Tillaart
 //    DATE: 02-febr-2013
-// VERSION: 0.4.1
+// VERSION: 0.5.0
 // PURPOSE: Arduino library for PCF8574 - 8 channel I2C IO expander
 //     URL: https://github.com/RobTillaart/PCF8574
 //          http://forum.arduino.cc/index.php?topic=184800
@@ -11,27 +11,93 @@
 
 #include "Arduino.h"
 #include "Wire.h"
+#include "PCF8574_clock.h"
+#include "PCF8574_callstats.h"
+#include "PCF8574_trace.h"
+#include "PCF8574_port.h"
+#include "PCF8574_sim.h"
+#include "PCF8574_interlock.h"
 
 
-#define PCF8574_LIB_VERSION         (F("0.4.1"))
+#define PCF8574_LIB_VERSION         (F("0.5.0"))
+
+//  define PCF8574_HEADER_ONLY for the WHOLE build (compiler flag)
+//  to inline read8(), write8(), write() and toggleMask().
+//  #define PCF8574_HEADER_ONLY
+
+//  define PCF8574_SIM for the WHOLE build (compiler flag)
+//  to enable setSim(), see PCF8574_sim.h.
+//  default the I/O path has no simulator branch.
+//  #define PCF8574_SIM
+
+//  optional features, define for the WHOLE build (compiler flag) as above.
+//  not defined => no member and no branch in the I/O path.
+//  #define PCF8574_CALLSTATS       setCallStats(), see PCF8574_callstats.h
+//  #define PCF8574_INTERLOCK       setInterlock(), see PCF8574_interlock.h
+//  #define PCF8574_RETAIN          setRetain(), warm restart
 
 #ifndef PCF8574_INITIAL_VALUE
 #define PCF8574_INITIAL_VALUE       0xFF
 #endif
 
+//  no init RAM for the warm restart, see PCF8574_Retain.
+//  not supported => empty, every start is a cold start.
+#ifndef PCF8574_NOINIT
+#if defined(__AVR__)
+#define PCF8574_NOINIT              __attribute__((section(".noinit")))
+#elif defined(ESP32)
+#define PCF8574_NOINIT              __NOINIT_ATTR
+#elif defined(ARDUINO_ARCH_RP2040)
+#define PCF8574_NOINIT              __attribute__((section(".uninitialized_data")))
+#else
+#define PCF8574_NOINIT
+#endif
+#endif
+
+
 #define PCF8574_OK                  0x00
 #define PCF8574_PIN_ERROR           0x81
 #define PCF8574_I2C_ERROR           0x82
+#define PCF8574_INTERLOCK_ERROR     0x83
+
+
+//  state that survives a watchdog or soft reset when placed in no init RAM.
+//  PCF8574_Retain retain[2] PCF8574_NOINIT;
+//  valid if magic matches and crc == CRC16 over magic .. buttonMask.
+struct PCF8574_Retain
+{
+  uint16_t magic;
+  uint8_t  address;
+  uint8_t  dataOut;
+  uint8_t  buttonMask;
+  uint16_t crc;
+};
+
 
+//  CRC16 Modbus (poly 0xA001 reflected, init 0xFFFF).
+uint16_t PCF8574_crc16(const uint8_t * data, const uint8_t length);
 
-class PCF8574
+
+class PCF8574 : public ExpanderPort<PCF8574>
 {
 public:
-  explicit PCF8574(const uint8_t deviceAddress = 0x20, TwoWire *wire = &Wire);
+  //  constexpr allows constant initialization of (arrays of) devices.
+  constexpr explicit PCF8574(const uint8_t deviceAddress = 0x20, TwoWire *wire = &Wire)
+  : _address {deviceAddress}, _wire {wire}
+  {}
 
+  //  with a valid retained state (warm restart) value is ignored,
+  //  the outputs are verified with one read and only rewritten if needed.
   bool    begin(uint8_t value = PCF8574_INITIAL_VALUE);
   bool    isConnected();
 
+#ifdef PCF8574_RETAIN
+  //  WARM RESTART
+  //  call before begin(), retain must be in no init RAM.
+  void    setRetain(PCF8574_Retain * retain) { _retain = retain; _retainActive = false; };
+  bool    isWarmStart() const { return _warmStart; };
+#endif
+
 
   //  note: setting the address corrupt internal buffer values
   //  a read8() / write8() call updates them.
@@ -45,14 +111,20 @@ public:
 
   void    write8(const uint8_t value);
   void    write(const uint8_t pin, const uint8_t value);
+  //  writes count values in one transaction, every value is latched
+  //  at its ACK (~9 clock pulses apart). count <= 31 (Wire buffer).
+  void    writeArray(const uint8_t * values, const uint8_t count);
   uint8_t valueOut() const { return _dataOut; }
+  //  checks last read value against valueOut(), no bus access.
+  //  false if an output written LOW reads HIGH, e.g. latch reset to 0xFF.
+  bool    isOutputValid() const { return (_dataIn & ~_dataOut) == 0; };
 
 
   //  added 0.1.07/08 Septillion
   uint8_t readButton8() { return PCF8574::readButton8(_buttonMask); }
   uint8_t readButton8(const uint8_t mask);
   uint8_t readButton(const uint8_t pin);
-  void    setButtonMask(const uint8_t mask) { _buttonMask = mask; };
+  void    setButtonMask(const uint8_t mask);
   uint8_t getButtonMask() const { return _buttonMask; };
 
 
@@ -76,17 +148,72 @@ public:
   int     lastError();
 
 
+  //  EXPANDER PORT concept, see PCF8574_port.h
+  static constexpr uint8_t  portWidth() { return 8; };
+  static constexpr uint16_t portCapabilities() { return EXPANDER_CAP_QUASI_BIDIR | EXPANDER_CAP_INTERRUPT; };
+  uint16_t portRead()  { return read8(); };
+  void     portWrite(const uint16_t value) { write8(value); };
+  uint16_t portValue() const    { return _dataIn; };
+  uint16_t portValueOut() const { return _dataOut; };
+
+
+#ifdef PCF8574_SIM
+  //  simulated bus, see PCF8574_sim.h
+  //  nullptr == use Wire (default)
+  void    setSim(PCF8574_Sim * sim) { _sim = sim; };
+  PCF8574_Sim * getSim() const { return _sim; };
+#endif
+
+
+#ifdef PCF8574_INTERLOCK
+  //  safety interlock, see PCF8574_interlock.h
+  //  nullptr == disabled (default)
+  void    setInterlock(PCF8574_Interlock * interlock) { _interlock = interlock; };
+  PCF8574_Interlock * getInterlock() const { return _interlock; };
+#endif
+
+
+#ifdef PCF8574_CALLSTATS
+  //  call site attribution, see PCF8574_callstats.h
+  //  nullptr == disabled (default)
+  void    setCallStats(PCF8574_CallStats * stats) { _stats = stats; };
+  PCF8574_CallStats * getCallStats() const { return _stats; };
+#endif
+
+
 private:
   int     _error {PCF8574_OK};
   uint8_t _address;
   uint8_t _dataIn {0};
   uint8_t _dataOut {0xFF};
   uint8_t _buttonMask {0xFF};
-  
+
 
   TwoWire*  _wire;
+#ifdef PCF8574_CALLSTATS
+  PCF8574_CallStats * _stats {nullptr};
+#endif
+#ifdef PCF8574_SIM
+  PCF8574_Sim * _sim {nullptr};
+#endif
+#ifdef PCF8574_INTERLOCK
+  PCF8574_Interlock * _interlock {nullptr};
+#endif
+
+#ifdef PCF8574_RETAIN
+  PCF8574_Retain * _retain {nullptr};
+  bool    _warmStart {false};
+  bool    _retainActive {false};
+  void    _updateRetain();
+#endif
 };
 
 
+#ifdef PCF8574_HEADER_ONLY
+#define PCF8574_INLINE    inline
+#include "PCF8574_hot.h"
+#endif
+
+
 //  -- END OF FILE --
 
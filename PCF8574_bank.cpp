@@ -0,0 +1,396 @@
+//
+//    FILE: PCF8574_bank.cpp
+//  AUTHOR: Rob Tillaart
+//    DATE: 2026-10-18
+// VERSION: 0.5.0
+// PURPOSE: Arduino library for PCF8574 - bank of devices
+//     URL: https://github.com/RobTillaart/PCF8574
+
+
+#include "PCF8574_bank.h"
+
+
+PCF8574_Bank::PCF8574_Bank()
+{
+  memset(_in, 0, sizeof(_in));
+  memset(_out, 0, sizeof(_out));
+  memset(_group, 0, sizeof(_group));
+  memset(_lastRefresh, 0, sizeof(_lastRefresh));
+}
+
+
+bool PCF8574_Bank::add(PCF8574 * device)
+{
+  if ((device == nullptr) || (_size >= PCF8574_BANK_SIZE)) return false;
+  _devices[_size++] = device;
+  return true;
+}
+
+
+PCF8574 * PCF8574_Bank::device(const uint8_t index)
+{
+  if (index >= _size) return nullptr;
+  return _devices[index];
+}
+
+
+bool PCF8574_Bank::begin()
+{
+  bool rv = true;
+  for (uint8_t i = 0; i < _size; i++)
+  {
+    if (! _devices[i]->begin()) rv = false;
+  }
+  publish();
+  return rv;
+}
+
+
+uint8_t PCF8574_Bank::read()
+{
+  uint8_t failed = 0;
+  for (uint8_t i = 0; i < _size; i++)
+  {
+    if (_readDevice(i) != PCF8574_OK) failed++;
+  }
+  publish();
+  return failed;
+}
+
+
+uint8_t PCF8574_Bank::read8(const uint8_t index)
+{
+  if (index >= _size) return 0;
+  _readDevice(index);
+  publish();
+  return _devices[index]->value();
+}
+
+
+uint8_t PCF8574_Bank::value(const uint8_t index) const
+{
+  if (index >= _size) return 0;
+  return _devices[index]->value();
+}
+
+
+/////////////////////////////////////////////////////////////
+//
+//  READ AHEAD
+//
+uint8_t PCF8574_Bank::service()
+{
+  //  round robin over the stale devices,
+  //  so a failing device does not starve the others.
+  for (uint8_t n = 0; n < _size; n++)
+  {
+    uint8_t i = _next;
+    _next++;
+    if (_next >= _size) _next = 0;
+    if (age(i) >= _maxAge)
+    {
+      _readDevice(i);
+      publish();
+      return i;
+    }
+  }
+  return _refresh();
+}
+
+
+uint32_t PCF8574_Bank::age(const uint8_t index) const
+{
+  if ((index >= _size) || ((_readMask & (1U << index)) == 0)) return PCF8574_AGE_UNKNOWN;
+  return PCF8574_micros() - _lastRead[index];
+}
+
+
+void PCF8574_Bank::setRefresh(const uint32_t interval, const uint8_t mode)
+{
+  _refreshInterval = interval;
+  _refreshMode = mode;
+}
+
+
+void PCF8574_Bank::setBusShare(const uint8_t percent)
+{
+  _busShare = percent;
+  if (_busShare < 1)   _busShare = 1;
+  if (_busShare > 100) _busShare = 100;
+}
+
+
+/////////////////////////////////////////////////////////////
+//
+//  SAMPLING
+//
+void PCF8574_Bank::setGroup(const uint8_t index, const uint8_t group)
+{
+  if (index >= _size) return;
+  _group[index] = group;
+}
+
+
+uint8_t PCF8574_Bank::getGroup(const uint8_t index) const
+{
+  if (index >= _size) return 0;
+  return _group[index];
+}
+
+
+uint8_t PCF8574_Bank::sample()
+{
+  uint8_t  failed = 0;
+  uint16_t done = 0;
+  _maxSkew = 0;
+  for (uint8_t i = 0; i < _size; i++)
+  {
+    if (done & (1U << i)) continue;
+    uint8_t  group = _group[i];
+    uint32_t first = 0;
+    uint32_t last = 0;
+    bool     valid = false;
+    //  read the whole group of device i back to back.
+    for (uint8_t j = i; j < _size; j++)
+    {
+      if ((j != i) && ((group == 0) || (_group[j] != group))) continue;
+      done |= (1U << j);
+      if (_readDevice(j) != PCF8574_OK)
+      {
+        failed++;
+        continue;
+      }
+      last = _lastRead[j];
+      if (! valid) first = last;
+      valid = true;
+    }
+    if (last - first > _maxSkew) _maxSkew = last - first;
+  }
+  publish();
+  return failed;
+}
+
+
+uint32_t PCF8574_Bank::timestamp(const uint8_t index) const
+{
+  if (index >= _size) return 0;
+  return _lastRead[index];
+}
+
+
+/////////////////////////////////////////////////////////////
+//
+//  COMMIT
+//
+void PCF8574_Bank::stage(const uint8_t index, const uint8_t value)
+{
+  if (index >= _size) return;
+  _staged[index] = value;
+  _stagedMask |= (1U << index);
+}
+
+
+uint8_t PCF8574_Bank::staged(const uint8_t index) const
+{
+  if (index >= _size) return 0;
+  if (_stagedMask & (1U << index)) return _staged[index];
+  return _devices[index]->valueOut();
+}
+
+
+uint8_t PCF8574_Bank::commit()
+{
+  //  collect the changed devices first,
+  //  so there is no CPU work between the writes.
+  uint8_t list[PCF8574_BANK_SIZE];
+  uint8_t count = 0;
+  for (uint8_t i = 0; i < _size; i++)
+  {
+    if ((_stagedMask & (1U << i)) && (_staged[i] != _devices[i]->valueOut()))
+    {
+      list[count++] = i;
+    }
+  }
+  _stagedMask = 0;
+  _commitSkew = 0;
+  if (count == 0) return 0;
+
+  _devices[list[0]]->write8(_staged[list[0]]);
+  uint32_t first = PCF8574_micros();
+  for (uint8_t n = 1; n < count; n++)
+  {
+    _devices[list[n]]->write8(_staged[list[n]]);
+  }
+  if (count > 1) _commitSkew = PCF8574_micros() - first;
+
+  uint8_t failed = 0;
+  for (uint8_t n = 0; n < count; n++)
+  {
+    if (_devices[list[n]]->lastError() != PCF8574_OK) failed++;
+  }
+  publish();
+  return failed;
+}
+
+
+/////////////////////////////////////////////////////////////
+//
+//  SLEEP
+//
+void PCF8574_Bank::sleep()
+{
+  _awakeTime = PCF8574_micros() - _wakeStart;
+}
+
+
+uint16_t PCF8574_Bank::wake()
+{
+  _wakeStart = PCF8574_micros();
+  _wakeCount++;
+  uint16_t changed = 0;
+  for (uint8_t i = 0; i < _size; i++)
+  {
+    uint16_t bit = (1U << i);
+    if ((_wakeMask & bit) == 0) continue;
+    uint8_t previous = _devices[i]->value();
+    if (_readDevice(i) != PCF8574_OK) continue;
+    if (_devices[i]->value() != previous) changed |= bit;
+    //  same read tells if the outputs survived.
+    if (_devices[i]->isOutputValid()) _invalidMask &= ~bit;
+    else                              _invalidMask |= bit;
+  }
+  publish();
+  return changed;
+}
+
+
+uint8_t PCF8574_Bank::resync()
+{
+  uint8_t count = 0;
+  for (uint8_t i = 0; i < _size; i++)
+  {
+    uint16_t bit = (1U << i);
+    if ((_invalidMask & bit) == 0) continue;
+    PCF8574 * dev = _devices[i];
+    dev->write8(dev->valueOut());
+    if (dev->lastError() == PCF8574_OK) _invalidMask &= ~bit;
+    count++;
+  }
+  if (count > 0) publish();
+  return count;
+}
+
+
+/////////////////////////////////////////////////////////////
+//
+//  SNAPSHOT
+//
+//  The writer fills the inactive buffer and then flips _active.
+//  A buffer is only rewritten two publishes later, so a reader
+//  is consistent if _seq moved at most 2 (1 if a publish was
+//  in progress at the start). An ISR on the core of the writer
+//  always succeeds in the first attempt.
+//
+void PCF8574_Bank::publish()
+{
+  uint8_t next = _active ^ 1;
+  _seq = _seq + 1;          //  odd
+  PCF8574_BARRIER();
+  for (uint8_t i = 0; i < _size; i++)
+  {
+    _in[next][i]  = _devices[i]->value();
+    _out[next][i] = _devices[i]->valueOut();
+  }
+  PCF8574_BARRIER();
+  _active = next;
+  _seq = _seq + 1;          //  even
+  PCF8574_BARRIER();
+}
+
+
+bool PCF8574_Bank::snapshot(uint8_t * in, uint8_t * out, uint8_t retries) const
+{
+  do
+  {
+    PCF8574_Seq s1 = _seq;
+    PCF8574_BARRIER();
+    uint8_t idx = _active;
+    for (uint8_t i = 0; i < _size; i++)
+    {
+      in[i] = _in[idx][i];
+      if (out != nullptr) out[i] = _out[idx][i];
+    }
+    PCF8574_BARRIER();
+    PCF8574_Seq delta = _seq - s1;
+    if ((delta < 2) || ((delta == 2) && ((s1 & 1) == 0))) return true;
+  }
+  while (retries-- > 0);
+  return false;
+}
+
+
+/////////////////////////////////////////////////////////////
+//
+//  PROTECTED
+//
+//  returns the error of the read.
+uint8_t PCF8574_Bank::_readDevice(const uint8_t index)
+{
+  _devices[index]->read8();
+  uint8_t error = _devices[index]->lastError();
+  if (error == PCF8574_OK)
+  {
+    _lastRead[index] = PCF8574_micros();
+    _readMask |= (1U << index);
+  }
+  return error;
+}
+
+
+
+//  refreshes the next due device, then holds off so the refresh
+//  transactions stay within busShare % of the bus time.
+uint8_t PCF8574_Bank::_refresh()
+{
+  if (_refreshInterval == 0) return PCF8574_BANK_NONE;
+  uint32_t now = PCF8574_micros();
+  if (now - _holdStart < _hold) return PCF8574_BANK_NONE;
+  for (uint8_t n = 0; n < _size; n++)
+  {
+    uint8_t i = _refreshNext;
+    _refreshNext++;
+    if (_refreshNext >= _size) _refreshNext = 0;
+    if (now - _lastRefresh[i] < _refreshInterval) continue;
+
+    PCF8574 * dev = _devices[i];
+    if (_refreshMode == PCF8574_REFRESH_VERIFY)
+    {
+      //  a line written LOW must not read HIGH (latch reset).
+      //  output lines, not in the button mask, must read back as written,
+      //  a button held LOW externally is not an error.
+      if ((_readDevice(i) == PCF8574_OK)
+         && (!dev->isOutputValid()
+            || (((dev->value() ^ dev->valueOut()) & ~dev->getButtonMask()) != 0)))
+      {
+        dev->write8(dev->valueOut());
+        dev->lastError();
+        _corrections++;
+      }
+    }
+    else
+    {
+      dev->write8(dev->valueOut());
+      dev->lastError();
+    }
+    _refreshCount++;
+    _lastRefresh[i] = now;
+    _holdStart = now;
+    _hold = (PCF8574_micros() - now) * 100UL / _busShare;
+    publish();
+    return i;
+  }
+  return PCF8574_BANK_NONE;
+}
+
+//  -- END OF FILE --
+
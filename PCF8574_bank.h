@@ -0,0 +1,199 @@
+#pragma once
+//
+//    FILE: PCF8574_bank.h
+//  AUTHOR: Rob Tillaart
+//    DATE: 2026-10-18
+// VERSION: 0.5.0
+// PURPOSE: Arduino library for PCF8574 - bank of devices
+//     URL: https://github.com/RobTillaart/PCF8574
+
+
+#include "PCF8574.h"
+
+
+//  max number of devices in a bank.
+#ifndef PCF8574_BANK_SIZE
+#define PCF8574_BANK_SIZE           16
+#endif
+
+#if PCF8574_BANK_SIZE > 16
+#error "PCF8574_BANK_SIZE max 16 (device masks are 16 bit)"
+#endif
+
+#define PCF8574_BANK_NONE           0xFF
+#define PCF8574_AGE_UNKNOWN         0xFFFFFFFF
+
+//  OUTPUT REFRESH MODES
+#define PCF8574_REFRESH_WRITE       0x00    //  rewrite valueOut()
+#define PCF8574_REFRESH_VERIFY      0x01    //  read, rewrite if an output line differs
+
+
+//  memory barrier for the snapshot.
+//  AVR is single core, a compiler barrier is sufficient.
+#if defined(__AVR__)
+#define PCF8574_BARRIER()           __asm__ __volatile__("" ::: "memory")
+#else
+#define PCF8574_BARRIER()           __sync_synchronize()
+#endif
+
+//  snapshot sequence number.
+//  AVR readers are ISRs on the core of the writer, they cannot be preempted
+//  by a publish, 8 bit is sufficient. On multi core a reader can be delayed
+//  for many publishes, 32 bit so _seq does not wrap around to the same value.
+#if defined(__AVR__)
+typedef uint8_t  PCF8574_Seq;
+#else
+typedef uint32_t PCF8574_Seq;
+#endif
+
+
+class PCF8574_Bank
+{
+public:
+  PCF8574_Bank();
+
+  //  returns false if the bank is full.
+  bool    add(PCF8574 * device);
+  uint8_t size() const { return _size; };
+  PCF8574 * device(const uint8_t index);
+
+  //  calls begin() of all devices, returns false if one fails.
+  bool    begin();
+  //  read8() all devices and publish the snapshot.
+  //  returns the number of devices that failed.
+  uint8_t read();
+  //  read8() one device and publish, returns value.
+  uint8_t read8(const uint8_t index);
+  //  cached input of a device, no bus access.
+  uint8_t value(const uint8_t index) const;
+
+
+  //  READ AHEAD
+  //  keeps the cached inputs fresher than maxAge micros,
+  //  by using idle time, call service() from loop().
+  void    setMaxAge(const uint32_t maxAge) { _maxAge = maxAge; };
+  uint32_t getMaxAge() const { return _maxAge; };
+  //  refreshes the next stale device (at most one transaction).
+  //  returns its index or PCF8574_BANK_NONE if all are fresh.
+  uint8_t service();
+  //  micros since last read of device, PCF8574_AGE_UNKNOWN if never read.
+  uint32_t age(const uint8_t index) const;
+
+
+  //  OUTPUT REFRESH
+  //  re-asserts valueOut() of every device each interval micros,
+  //  done by service() when no read ahead is needed. 0 == disabled (default).
+  void    setRefresh(const uint32_t interval, const uint8_t mode = PCF8574_REFRESH_WRITE);
+  uint32_t getRefreshInterval() const { return _refreshInterval; };
+  uint8_t getRefreshMode() const { return _refreshMode; };
+  //  max percentage of bus time used by refresh, 1..100, default 10.
+  void    setBusShare(const uint8_t percent);
+  uint8_t getBusShare() const { return _busShare; };
+  uint32_t refreshCount() const { return _refreshCount; };
+  //  outputs found invalid and rewritten (verify mode).
+  uint32_t corrections() const  { return _corrections; };
+
+
+  //  SAMPLING
+  //  devices with the same group (1..255) are read back to back,
+  //  to minimize the skew between related signals. 0 = no group.
+  void    setGroup(const uint8_t index, const uint8_t group);
+  uint8_t getGroup(const uint8_t index) const;
+  //  read8() all devices in group order and publish.
+  //  returns the number of devices that failed.
+  uint8_t sample();
+  //  max time in micros between the first and last read of a group, last sample().
+  uint32_t maxSkew() const { return _maxSkew; };
+  //  PCF8574_micros() of the last successful read of a device.
+  uint32_t timestamp(const uint8_t index) const;
+
+
+  //  COMMIT
+  //  stage new output values, not visible until commit().
+  void    stage(const uint8_t index, const uint8_t value);
+  //  staged value, or valueOut() if nothing is staged.
+  uint8_t staged(const uint8_t index) const;
+  void    discard() { _stagedMask = 0; };
+  //  writes the staged values that differ from valueOut(), back to back,
+  //  and publish. Returns the number of devices that failed.
+  uint8_t commit();
+  //  micros between the first and last write of the last commit().
+  uint32_t commitSkew() const { return _commitSkew; };
+
+
+  //  SLEEP
+  //  devices that are read on wake, typically the ones with INT connected.
+  void    setWakeMask(const uint16_t mask) { _wakeMask = mask; };
+  uint16_t getWakeMask() const { return _wakeMask; };
+  //  call just before the processor goes to sleep.
+  void    sleep();
+  //  call after wake up, reads every device in the wake mask once.
+  //  returns mask of devices with changed inputs.
+  uint16_t wake();
+  //  mask of devices whose outputs did not survive (see isOutputValid()).
+  uint16_t invalid() const { return _invalidMask; };
+  //  rewrites only the invalid devices, returns number rewritten.
+  uint8_t resync();
+  //  micros between the last wake() and sleep().
+  uint32_t awakeTime() const { return _awakeTime; };
+  uint32_t wakeCount() const { return _wakeCount; };
+
+
+  //  SNAPSHOT
+  //  The bus owner (writer) publishes the inputs and outputs of all devices,
+  //  readers (ISR, other core) get a consistent copy without locks or bus access.
+  //  The writer never waits for readers.
+  //  publish() is called by read(), call it after writing devices directly.
+  void    publish();
+  //  in and out must hold size() bytes, out may be nullptr.
+  //  returns false if no consistent copy was made in retries attempts,
+  //  only possible when the other core publishes continuously.
+  bool    snapshot(uint8_t * in, uint8_t * out, uint8_t retries = 4) const;
+  //  changes with every publish().
+  PCF8574_Seq sequence() const { return _seq; };
+
+
+protected:
+  PCF8574 * _devices[PCF8574_BANK_SIZE];
+  uint8_t   _size {0};
+
+  uint8_t   _readDevice(const uint8_t index);
+  uint32_t  _lastRead[PCF8574_BANK_SIZE];
+  uint16_t  _readMask {0};       //  devices read at least once
+  uint32_t  _maxAge {10000};
+  uint8_t   _next {0};
+
+  uint8_t   _refresh();
+  uint32_t  _refreshInterval {0};
+  uint8_t   _refreshMode {PCF8574_REFRESH_WRITE};
+  uint8_t   _busShare {10};
+  uint8_t   _refreshNext {0};
+  uint32_t  _lastRefresh[PCF8574_BANK_SIZE];
+  uint32_t  _holdStart {0};
+  uint32_t  _hold {0};
+  uint32_t  _refreshCount {0};
+  uint32_t  _corrections {0};
+
+  uint8_t   _group[PCF8574_BANK_SIZE];
+  uint32_t  _maxSkew {0};
+
+  uint8_t   _staged[PCF8574_BANK_SIZE];
+  uint16_t  _stagedMask {0};
+  uint32_t  _commitSkew {0};
+
+  uint16_t  _wakeMask {0xFFFF};
+  uint16_t  _invalidMask {0};
+  uint32_t  _wakeStart {0};
+  uint32_t  _awakeTime {0};
+  uint32_t  _wakeCount {0};
+
+  //  double buffered seqlock, _seq is odd during a publish.
+  volatile PCF8574_Seq _seq {0};
+  volatile uint8_t _active {0};
+  uint8_t   _in[2][PCF8574_BANK_SIZE];
+  uint8_t   _out[2][PCF8574_BANK_SIZE];
+};
+
+
+//  -- END OF FILE --
+
@@ -0,0 +1,109 @@
+//
+//    FILE: PCF8574_board.cpp
+//  AUTHOR: Rob Tillaart
+//    DATE: 2026-10-18
+// VERSION: 0.5.0
+// PURPOSE: Arduino library for PCF8574 - compile time board description
+//     URL: https://github.com/RobTillaart/PCF8574
+
+
+#include "PCF8574_board.h"
+
+
+bool PCF8574_Board::begin()
+{
+  bool rv = true;
+  for (uint8_t d = 0; d < _deviceCount; d++)
+  {
+    _devices[d].setButtonMask(_masks[d].buttonMask);
+    if (! _devices[d].begin(_masks[d].initialValue))
+    {
+      //  begin() does not set an error if not connected.
+      int e = _devices[d].lastError();
+      _error = (e != PCF8574_OK) ? e : PCF8574_I2C_ERROR;
+      _errorDevice = d;
+      rv = false;
+    }
+    else _check(d);
+  }
+  return rv;
+}
+
+
+PCF8574 * PCF8574_Board::device(const uint8_t index)
+{
+  if (index >= _pinCount) return nullptr;
+  return &_devices[_pins[index].device];
+}
+
+
+uint8_t PCF8574_Board::read(const uint8_t index)
+{
+  if (index >= _pinCount)
+  {
+    _error = PCF8574_PIN_ERROR;
+    _errorDevice = PCF8574_BOARD_NONE;
+    return 0;
+  }
+  const PCF8574_PinDef & p = _pins[index];
+  uint8_t value = _devices[p.device].read(p.pin);
+  _check(p.device);
+  if (p.flags & PCF8574_PIN_INVERTED) value ^= 1;
+  return value;
+}
+
+
+void PCF8574_Board::write(const uint8_t index, const uint8_t value)
+{
+  if (index >= _pinCount)
+  {
+    _error = PCF8574_PIN_ERROR;
+    _errorDevice = PCF8574_BOARD_NONE;
+    return;
+  }
+  const PCF8574_PinDef & p = _pins[index];
+  uint8_t level = (value != LOW);
+  if (p.flags & PCF8574_PIN_INVERTED) level ^= 1;
+  _devices[p.device].write(p.pin, level);
+  _check(p.device);
+}
+
+
+void PCF8574_Board::toggle(const uint8_t index)
+{
+  if (index >= _pinCount)
+  {
+    _error = PCF8574_PIN_ERROR;
+    _errorDevice = PCF8574_BOARD_NONE;
+    return;
+  }
+  const PCF8574_PinDef & p = _pins[index];
+  _devices[p.device].toggle(p.pin);
+  _check(p.device);
+}
+
+
+int PCF8574_Board::lastError()
+{
+  int e = _error;
+  _error = PCF8574_OK;
+  return e;
+}
+
+
+/////////////////////////////////////////////////////////////
+//
+//  PRIVATE
+//
+//  keeps the error of the device, lastError() of a device resets it.
+void PCF8574_Board::_check(const uint8_t device)
+{
+  int e = _devices[device].lastError();
+  if (e == PCF8574_OK) return;
+  _error = e;
+  _errorDevice = device;
+}
+
+
+//  -- END OF FILE --
+
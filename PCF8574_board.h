@@ -0,0 +1,183 @@
+#pragma once
+//
+//    FILE: PCF8574_board.h
+//  AUTHOR: Rob Tillaart
+//    DATE: 2026-10-18
+// VERSION: 0.5.0
+// PURPOSE: Arduino library for PCF8574 - compile time board description
+//     URL: https://github.com/RobTillaart/PCF8574
+
+
+#include "PCF8574.h"
+
+
+//  PIN FLAGS
+#define PCF8574_PIN_OUTPUT          0x00
+#define PCF8574_PIN_INPUT           0x01
+#define PCF8574_PIN_INVERTED        0x02
+
+#define PCF8574_BOARD_NONE          0xFF
+
+
+//  one entry per used pin of the board.
+struct PCF8574_PinDef
+{
+  uint8_t device;    //  index in the device table
+  uint8_t pin;       //  0..7
+  uint8_t flags;     //  PCF8574_PIN_xxx
+};
+
+
+//////////////////////////////////////////////////////////////
+//
+//  CONSTEXPR HELPERS
+//
+//  C++11 constexpr => single return statement, so recursive.
+//  These can be used in constexpr variables and static_assert()
+//  to get the masks of a board at compile time.
+//
+
+//  mask of the pins of device where (flags & flag) == value
+constexpr uint8_t PCF8574_boardMask(const PCF8574_PinDef * pins, const uint8_t count,
+                                    const uint8_t device, const uint8_t flag, const uint8_t value)
+{
+  return (count == 0) ? 0 :
+         (((pins[0].device == device) && ((pins[0].flags & flag) == value)) ? (1 << pins[0].pin) : 0)
+         | PCF8574_boardMask(pins + 1, count - 1, device, flag, value);
+}
+
+//  input lines == button mask
+constexpr uint8_t PCF8574_buttonMask(const PCF8574_PinDef * pins, const uint8_t count, const uint8_t device)
+{
+  return PCF8574_boardMask(pins, count, device, PCF8574_PIN_INPUT, PCF8574_PIN_INPUT);
+}
+
+constexpr uint8_t PCF8574_outputMask(const PCF8574_PinDef * pins, const uint8_t count, const uint8_t device)
+{
+  return PCF8574_boardMask(pins, count, device, PCF8574_PIN_INPUT, PCF8574_PIN_OUTPUT);
+}
+
+constexpr uint8_t PCF8574_invertMask(const PCF8574_PinDef * pins, const uint8_t count, const uint8_t device)
+{
+  return PCF8574_boardMask(pins, count, device, PCF8574_PIN_INVERTED, PCF8574_PIN_INVERTED);
+}
+
+//  outputs inactive (inverted outputs HIGH, others LOW),
+//  inputs and unused lines HIGH (PCF8574 power on state).
+constexpr uint8_t PCF8574_initialValue(const PCF8574_PinDef * pins, const uint8_t count, const uint8_t device)
+{
+  return ~(PCF8574_outputMask(pins, count, device) & ~PCF8574_invertMask(pins, count, device));
+}
+
+//  true if pin < 8, device < deviceCount and no line is used twice.
+constexpr bool PCF8574_boardValid(const PCF8574_PinDef * pins, const uint8_t count, const uint8_t deviceCount)
+{
+  return (count == 0) ? true :
+         (pins[0].pin < 8) && (pins[0].device < deviceCount)
+         && (PCF8574_boardMask(pins + 1, count - 1, pins[0].device, 0, 0) & (1 << pins[0].pin)) == 0
+         && PCF8574_boardValid(pins + 1, count - 1, deviceCount);
+}
+
+
+//////////////////////////////////////////////////////////////
+//
+//  COMPILE TIME MASK TABLE
+//
+//  masks[device] is a static constexpr member, so the helpers above
+//  are evaluated by the compiler, begin() only copies the values.
+//  PINS must be a pin table at namespace scope (static storage).
+//
+struct PCF8574_DeviceMasks
+{
+  uint8_t buttonMask;
+  uint8_t initialValue;
+};
+
+
+template <uint8_t... I> struct PCF8574_Indices {};
+template <uint8_t N, uint8_t... I> struct PCF8574_MakeIndices : PCF8574_MakeIndices<N - 1, N - 1, I...> {};
+template <uint8_t... I> struct PCF8574_MakeIndices<0, I...> { typedef PCF8574_Indices<I...> type; };
+
+
+template <const PCF8574_PinDef * PINS, uint8_t PIN_COUNT, uint8_t DEVICE_COUNT,
+          typename = typename PCF8574_MakeIndices<DEVICE_COUNT>::type>
+struct PCF8574_BoardMasks;
+
+template <const PCF8574_PinDef * PINS, uint8_t PIN_COUNT, uint8_t DEVICE_COUNT, uint8_t... I>
+struct PCF8574_BoardMasks<PINS, PIN_COUNT, DEVICE_COUNT, PCF8574_Indices<I...> >
+{
+  static_assert(PCF8574_boardValid(PINS, PIN_COUNT, DEVICE_COUNT), "invalid board description");
+  static constexpr PCF8574_DeviceMasks masks[DEVICE_COUNT] =
+  {
+    { PCF8574_buttonMask(PINS, PIN_COUNT, I), PCF8574_initialValue(PINS, PIN_COUNT, I) }...
+  };
+};
+
+template <const PCF8574_PinDef * PINS, uint8_t PIN_COUNT, uint8_t DEVICE_COUNT, uint8_t... I>
+constexpr PCF8574_DeviceMasks PCF8574_BoardMasks<PINS, PIN_COUNT, DEVICE_COUNT, PCF8574_Indices<I...> >::masks[DEVICE_COUNT];
+
+
+//////////////////////////////////////////////////////////////
+//
+//  BOARD
+//
+class PCF8574_Board
+{
+public:
+  //  devices, pins and masks are not copied, they must stay in scope.
+  //  masks[deviceCount], see PCF8574_BoardMasks and PCF8574_BoardOf.
+  constexpr PCF8574_Board(PCF8574 * devices, const uint8_t deviceCount,
+                          const PCF8574_PinDef * pins, const uint8_t pinCount,
+                          const PCF8574_DeviceMasks * masks)
+  : _devices {devices}, _pins {pins}, _masks {masks}, _deviceCount {deviceCount}, _pinCount {pinCount}
+  {}
+
+  //  sets button mask and initial value of all devices.
+  //  returns false if one or more devices are not connected.
+  bool    begin();
+
+  uint8_t deviceCount() const { return _deviceCount; };
+  uint8_t pinCount() const    { return _pinCount; };
+  //  device of a board pin, nullptr if index out of range.
+  PCF8574 * device(const uint8_t index);
+
+  //  index = index in pin table, polarity is applied.
+  uint8_t read(const uint8_t index);
+  void    write(const uint8_t index, const uint8_t value);
+  void    toggle(const uint8_t index);
+
+  //  error of the device that failed (PCF8574_I2C_ERROR if not connected
+  //  at begin()) or PCF8574_PIN_ERROR.
+  int     lastError();
+  //  index of the device of the last error, PCF8574_BOARD_NONE if none or pin error.
+  uint8_t lastErrorDevice() const { return _errorDevice; };
+
+
+private:
+  PCF8574 *                   _devices;
+  const PCF8574_PinDef *      _pins;
+  const PCF8574_DeviceMasks * _masks;
+  uint8_t _deviceCount;
+  uint8_t _pinCount;
+  int     _error {PCF8574_OK};
+  uint8_t _errorDevice {PCF8574_BOARD_NONE};
+
+  void    _check(const uint8_t device);
+};
+
+
+//  board with the masks generated from the pin table at compile time.
+//  usage:  PCF8574_BoardOf<pins, PIN_COUNT, 2> board(devices);
+template <const PCF8574_PinDef * PINS, uint8_t PIN_COUNT, uint8_t DEVICE_COUNT>
+class PCF8574_BoardOf : public PCF8574_Board
+{
+public:
+  constexpr explicit PCF8574_BoardOf(PCF8574 * devices)
+  : PCF8574_Board(devices, DEVICE_COUNT, PINS, PIN_COUNT,
+                  PCF8574_BoardMasks<PINS, PIN_COUNT, DEVICE_COUNT>::masks)
+  {}
+};
+
+
+//  -- END OF FILE --
+
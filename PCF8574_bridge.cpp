@@ -0,0 +1,318 @@
+//
+//    FILE: PCF8574_bridge.cpp
+//  AUTHOR: Rob Tillaart
+//    DATE: 2026-10-18
+// VERSION: 0.5.0
+// PURPOSE: Arduino library for PCF8574 - binary serial bridge for batched access
+//     URL: https://github.com/RobTillaart/PCF8574
+
+
+#include "PCF8574_bridge.h"
+
+
+PCF8574_Bridge::PCF8574_Bridge(PCF8574_Bank * bank)
+: _bank {bank}
+{
+}
+
+
+void PCF8574_Bridge::begin(Stream * stream)
+{
+  _stream = stream;
+  _length = 0;
+}
+
+
+bool PCF8574_Bridge::poll()
+{
+  if (_stream == nullptr) return false;
+  if ((_length > 0) && (PCF8574_millis() - _lastByte > PCF8574_BRIDGE_TIMEOUT)) _length = 0;
+  while (_stream->available() > 0)
+  {
+    uint8_t c = _stream->read();
+    _lastByte = PCF8574_millis();
+    if ((_length == 0) && (c != PCF8574_BRIDGE_SYNC)) continue;
+    _buffer[_length++] = c;
+    if (_length < 2) continue;
+    uint16_t total = _buffer[1] + 4;
+    if ((_buffer[1] == 0) || (total > PCF8574_BRIDGE_BUFFER))
+    {
+      _length = 0;  //  resync
+      continue;
+    }
+    if (_length < total) continue;
+
+    uint8_t response[PCF8574_BRIDGE_BUFFER];
+    uint8_t n = process(_buffer, _length, response);
+    if (n > 0) _stream->write(response, n);
+    _length = 0;
+    return true;
+  }
+  return false;
+}
+
+
+uint8_t PCF8574_Bridge::process(const uint8_t * frame, const uint8_t length, uint8_t * response)
+{
+  if ((length < 5) || (frame[0] != PCF8574_BRIDGE_SYNC) || (frame[1] != length - 4)) return 0;
+  uint16_t crc = frame[length - 2] | (frame[length - 1] << 8);
+  if (PCF8574_crc16(&frame[1], length - 3) != crc)
+  {
+    _crcErrors++;
+    return 0;
+  }
+  _requests++;
+  _transactions = 0;
+
+  uint8_t seq = frame[2];
+  const uint8_t * ops = &frame[3];
+  uint8_t size = frame[1] - 1;
+  //  validate first, a bad request executes nothing.
+  int16_t results = _check(ops, size);
+  if ((results < 0) || (6 + results > PCF8574_BRIDGE_BUFFER))
+  {
+    return _respond(response, seq, PCF8574_BR_BAD_REQUEST, 0);
+  }
+
+  //  adjacent writes and masked writes to the same device are
+  //  coalesced into one write8(), any other operation flushes it first,
+  //  so the bus order is the order of the request.
+  _pendingDevice = PCF8574_BANK_NONE;
+  uint8_t status = PCF8574_BR_OK;
+  uint8_t count = 0;
+  uint8_t vmResults = 0;
+  uint16_t i = 0;
+  while ((i < size) && (status == PCF8574_BR_OK))
+  {
+    uint8_t op  = ops[i];
+    uint8_t dev = ((op == PCF8574_BR_READ_ALL) || (op == PCF8574_BR_RUN)) ? 0 : ops[i + 1];
+    bool coalesce = ((op == PCF8574_BR_WRITE) || (op == PCF8574_BR_MASK)) && (dev == _pendingDevice);
+    if (! coalesce && (_flush() != PCF8574_OK))
+    {
+      status = PCF8574_BR_IO_ERROR;
+      break;
+    }
+    switch (op)
+    {
+      case PCF8574_BR_READ:
+        response[4 + count++] = _bank->device(dev)->read8();
+        _transactions++;
+        if (_bank->device(dev)->lastError() != PCF8574_OK) status = PCF8574_BR_IO_ERROR;
+        i += 2;
+        break;
+      case PCF8574_BR_WRITE:
+        _pendingDevice = dev;
+        _pendingValue  = ops[i + 2];
+        i += 3;
+        break;
+      case PCF8574_BR_MASK:
+      {
+        uint8_t base = coalesce ? _pendingValue : _bank->device(dev)->valueOut();
+        _pendingDevice = dev;
+        _pendingValue  = (base & ~ops[i + 2]) | (ops[i + 3] & ops[i + 2]);
+        i += 4;
+        break;
+      }
+      case PCF8574_BR_STREAM:
+        _bank->device(dev)->writeArray(&ops[i + 3], ops[i + 2]);
+        _transactions++;
+        if (_bank->device(dev)->lastError() != PCF8574_OK) status = PCF8574_BR_IO_ERROR;
+        i += 3 + ops[i + 2];
+        break;
+      case PCF8574_BR_READ_ALL:
+        for (uint8_t d = 0; (d < _bank->size()) && (status == PCF8574_BR_OK); d++)
+        {
+          response[4 + count++] = _bank->device(d)->read8();
+          _transactions++;
+          if (_bank->device(d)->lastError() != PCF8574_OK) status = PCF8574_BR_IO_ERROR;
+        }
+        i += 1;
+        break;
+      case PCF8574_BR_RUN:
+      {
+        //  keep room for the results of the reads that follow.
+        uint8_t reserved = results - (count - vmResults);
+        PCF8574_VM vm(_bank);
+        vm.setResultBuffer(&response[4 + count], PCF8574_BRIDGE_BUFFER - 6 - count - reserved);
+        if (vm.run(&ops[i + 2], ops[i + 1]) != PCF8574_VM_OK) status = PCF8574_BR_VM_ERROR;
+        count += vm.resultCount();
+        vmResults += vm.resultCount();
+        _transactions += vm.transactions();
+        i += 2 + ops[i + 1];
+        break;
+      }
+    }
+  }
+  if ((status == PCF8574_BR_OK) && (_flush() != PCF8574_OK)) status = PCF8574_BR_IO_ERROR;
+  if (_transactions > 0) _bank->publish();
+  return _respond(response, seq, status, count);
+}
+
+
+/////////////////////////////////////////////////////////////
+//
+//  PRIVATE
+//
+//  returns number of result bytes, -1 == bad request.
+int16_t PCF8574_Bridge::_check(const uint8_t * ops, const uint8_t length)
+{
+  int16_t  results = 0;
+  uint16_t i = 0;
+  while (i < length)
+  {
+    uint8_t op = ops[i];
+    if (op == PCF8574_BR_READ_ALL)
+    {
+      results += _bank->size();
+      i += 1;
+      continue;
+    }
+    if (op == PCF8574_BR_RUN)
+    {
+      //  program is checked by the VM, results are not known in advance.
+      if ((i + 1 >= length) || (i + 2 + ops[i + 1] > length)) return -1;
+      i += 2 + ops[i + 1];
+      continue;
+    }
+    if ((i + 1 >= length) || (ops[i + 1] >= _bank->size())) return -1;
+    switch (op)
+    {
+      case PCF8574_BR_READ:   results++; i += 2; break;
+      case PCF8574_BR_WRITE:  i += 3; break;
+      case PCF8574_BR_MASK:   i += 4; break;
+      case PCF8574_BR_STREAM:
+        //  count 1..31, Wire buffer.
+        if ((i + 2 >= length) || (ops[i + 2] == 0) || (ops[i + 2] > 31)) return -1;
+        i += 3 + ops[i + 2];
+        break;
+      default:
+        return -1;
+    }
+  }
+  if (i != length) return -1;  //  truncated
+  return results;
+}
+
+
+//  writes the pending value if it differs from valueOut().
+uint8_t PCF8574_Bridge::_flush()
+{
+  if (_pendingDevice == PCF8574_BANK_NONE) return PCF8574_OK;
+  PCF8574 * dev = _bank->device(_pendingDevice);
+  _pendingDevice = PCF8574_BANK_NONE;
+  if (_pendingValue == dev->valueOut()) return PCF8574_OK;
+  dev->write8(_pendingValue);
+  _transactions++;
+  return dev->lastError();
+}
+
+
+uint8_t PCF8574_Bridge::_respond(uint8_t * response, const uint8_t seq, const uint8_t status, const uint8_t count)
+{
+  response[0] = PCF8574_BRIDGE_SYNC;
+  response[1] = 2 + count;
+  response[2] = seq;
+  response[3] = status;
+  uint16_t crc = PCF8574_crc16(&response[1], 3 + count);
+  response[4 + count] = crc & 0xFF;
+  response[5 + count] = crc >> 8;
+  return 6 + count;
+}
+
+
+/////////////////////////////////////////////////////////////
+//
+//  REQUEST BUILDER
+//
+PCF8574_BridgeRequest::PCF8574_BridgeRequest()
+{
+  clear();
+}
+
+
+void PCF8574_BridgeRequest::clear()
+{
+  _seq++;
+  _frame[0] = PCF8574_BRIDGE_SYNC;
+  _frame[2] = _seq;
+  _length = 3;
+}
+
+
+bool PCF8574_BridgeRequest::read(const uint8_t dev)
+{
+  uint8_t data[2] = { PCF8574_BR_READ, dev };
+  return _add(data, 2);
+}
+
+
+bool PCF8574_BridgeRequest::write(const uint8_t dev, const uint8_t value)
+{
+  uint8_t data[3] = { PCF8574_BR_WRITE, dev, value };
+  return _add(data, 3);
+}
+
+
+bool PCF8574_BridgeRequest::mask(const uint8_t dev, const uint8_t mask, const uint8_t value)
+{
+  uint8_t data[4] = { PCF8574_BR_MASK, dev, mask, value };
+  return _add(data, 4);
+}
+
+
+bool PCF8574_BridgeRequest::stream(const uint8_t dev, const uint8_t * values, const uint8_t count)
+{
+  if ((count == 0) || (_length + 3 + count + 2 > PCF8574_BRIDGE_BUFFER)) return false;
+  uint8_t data[3] = { PCF8574_BR_STREAM, dev, count };
+  _add(data, 3);
+  return _add(values, count);
+}
+
+
+bool PCF8574_BridgeRequest::readAll()
+{
+  uint8_t data[1] = { PCF8574_BR_READ_ALL };
+  return _add(data, 1);
+}
+
+
+bool PCF8574_BridgeRequest::run(const uint8_t * program, const uint8_t length)
+{
+  if (_length + 2 + length + 2 > PCF8574_BRIDGE_BUFFER) return false;
+  uint8_t data[2] = { PCF8574_BR_RUN, length };
+  _add(data, 2);
+  return _add(program, length);
+}
+
+
+uint8_t PCF8574_BridgeRequest::finish()
+{
+  _frame[1] = _length - 2;
+  uint16_t crc = PCF8574_crc16(&_frame[1], _length - 1);
+  _frame[_length]     = crc & 0xFF;
+  _frame[_length + 1] = crc >> 8;
+  return _length + 2;
+}
+
+
+bool PCF8574_BridgeRequest::check(const uint8_t * response, const uint8_t length, const uint8_t seq)
+{
+  if ((length < 6) || (response[0] != PCF8574_BRIDGE_SYNC) || (response[1] != length - 4)) return false;
+  uint16_t crc = response[length - 2] | (response[length - 1] << 8);
+  if (PCF8574_crc16(&response[1], length - 3) != crc) return false;
+  return response[2] == seq;
+}
+
+
+bool PCF8574_BridgeRequest::_add(const uint8_t * data, const uint8_t count)
+{
+  //  keep room for the CRC.
+  if (_length + count + 2 > PCF8574_BRIDGE_BUFFER) return false;
+  memcpy(&_frame[_length], data, count);
+  _length += count;
+  return true;
+}
+
+
+//  -- END OF FILE --
+
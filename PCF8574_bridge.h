@@ -0,0 +1,121 @@
+#pragma once
+//
+//    FILE: PCF8574_bridge.h
+//  AUTHOR: Rob Tillaart
+//    DATE: 2026-10-18
+// VERSION: 0.5.0
+// PURPOSE: Arduino library for PCF8574 - binary serial bridge for batched access
+//     URL: https://github.com/RobTillaart/PCF8574
+//
+//  FRAME (request and response)
+//    0xA5  LEN  SEQ  DATA[LEN-1]  CRC_LO  CRC_HI
+//    LEN = bytes of SEQ + DATA, CRC = Modbus CRC16 over LEN, SEQ, DATA.
+//  request DATA  = operations, see PCF8574_BR_xxx.
+//  response DATA = STATUS, results of the read operations in order.
+//  SEQ is echoed, so a host can pipeline several requests.
+
+
+#include "PCF8574_bank.h"
+#include "PCF8574_vm.h"
+
+
+#ifndef PCF8574_BRIDGE_BUFFER
+#define PCF8574_BRIDGE_BUFFER       64
+#endif
+
+#define PCF8574_BRIDGE_SYNC         0xA5
+#define PCF8574_BRIDGE_TIMEOUT      100     //  millis, incomplete frame is dropped
+
+//  OPERATIONS                                  ARGUMENTS           RESULT
+#define PCF8574_BR_READ             0x01    //  dev                 value
+#define PCF8574_BR_WRITE            0x02    //  dev value
+#define PCF8574_BR_MASK             0x03    //  dev mask value
+#define PCF8574_BR_STREAM           0x04    //  dev count values[]
+#define PCF8574_BR_READ_ALL         0x05    //  -                   value[size]
+#define PCF8574_BR_RUN              0x06    //  length program[]    VM results, see PCF8574_vm.h
+
+//  STATUS
+#define PCF8574_BR_OK               0x00
+#define PCF8574_BR_BAD_REQUEST      0x01    //  unknown op, bad device, too long, nothing executed
+#define PCF8574_BR_IO_ERROR         0x02    //  I2C error, execution stopped
+#define PCF8574_BR_VM_ERROR         0x03    //  program did not end OK, execution stopped
+
+
+class PCF8574_Bridge
+{
+public:
+  explicit PCF8574_Bridge(PCF8574_Bank * bank);
+
+  //  STREAM
+  void     begin(Stream * stream);
+  //  call from loop(), returns true if a request was handled.
+  bool     poll();
+
+  //  TRANSPORT INDEPENDENT
+  //  handles one complete frame, fills response (PCF8574_BRIDGE_BUFFER bytes)
+  //  returns its length, 0 == no response (bad frame).
+  uint8_t  process(const uint8_t * frame, const uint8_t length, uint8_t * response);
+
+  uint32_t requests() const     { return _requests; };
+  uint32_t crcErrors() const    { return _crcErrors; };
+  //  I2C transactions of the last request, after coalescing.
+  uint16_t transactions() const { return _transactions; };
+
+
+private:
+  PCF8574_Bank * _bank;
+
+  Stream *  _stream {nullptr};
+  uint8_t   _buffer[PCF8574_BRIDGE_BUFFER];
+  uint8_t   _length {0};
+  uint32_t  _lastByte {0};
+
+  uint32_t  _requests {0};
+  uint32_t  _crcErrors {0};
+  uint16_t  _transactions {0};
+
+  //  pending (coalesced) write.
+  uint8_t   _pendingDevice {PCF8574_BANK_NONE};
+  uint8_t   _pendingValue {0};
+
+  int16_t   _check(const uint8_t * ops, const uint8_t length);
+  uint8_t   _flush();
+  uint8_t   _respond(uint8_t * response, const uint8_t seq, const uint8_t status, const uint8_t count);
+};
+
+
+//  builds request frames and checks responses, for a host or another MCU.
+class PCF8574_BridgeRequest
+{
+public:
+  PCF8574_BridgeRequest();
+
+  //  starts a new request, sequence number increments.
+  void     clear();
+  bool     read(const uint8_t dev);
+  bool     write(const uint8_t dev, const uint8_t value);
+  bool     mask(const uint8_t dev, const uint8_t mask, const uint8_t value);
+  bool     stream(const uint8_t dev, const uint8_t * values, const uint8_t count);
+  bool     readAll();
+  bool     run(const uint8_t * program, const uint8_t length);
+
+  //  adds LEN and CRC, returns frame length.
+  uint8_t  finish();
+  const uint8_t * frame() const { return _frame; };
+  uint8_t  sequence() const { return _seq; };
+
+  //  returns true if response is valid and matches the sequence.
+  static bool check(const uint8_t * response, const uint8_t length, const uint8_t seq);
+
+
+private:
+  uint8_t  _frame[PCF8574_BRIDGE_BUFFER];
+  uint8_t  _length {0};
+  uint8_t  _seq {0};
+
+  bool     _add(const uint8_t * data, const uint8_t count);
+};
+
+
+//  -- END OF FILE --
+
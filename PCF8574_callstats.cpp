@@ -0,0 +1,85 @@
+//
+//    FILE: PCF8574_callstats.cpp
+//  AUTHOR: Rob Tillaart
+//    DATE: 2026-10-18
+// VERSION: 0.5.0
+// PURPOSE: Arduino library for PCF8574 - call site attribution of I2C traffic
+//     URL: https://github.com/RobTillaart/PCF8574
+
+
+#include "PCF8574_callstats.h"
+
+
+PCF8574_CallStats::PCF8574_CallStats()
+{
+  reset();
+}
+
+
+void PCF8574_CallStats::setCaller(const char * file, const uint16_t line)
+{
+  _file = file;
+  _line = line;
+}
+
+
+void PCF8574_CallStats::record(const uint32_t duration)
+{
+  for (uint8_t i = 0; i < _size; i++)
+  {
+    if ((_sites[i].line == _line) && (_sites[i].file == _file))
+    {
+      _sites[i].count++;
+      _sites[i].busTime += duration;
+      return;
+    }
+  }
+  if (_size >= PCF8574_CALLSTATS_SIZE)
+  {
+    _dropped++;
+    return;
+  }
+  _sites[_size].file    = _file;
+  _sites[_size].line    = _line;
+  _sites[_size].count   = 1;
+  _sites[_size].busTime = duration;
+  _size++;
+}
+
+
+void PCF8574_CallStats::reset()
+{
+  _size = 0;
+  _dropped = 0;
+}
+
+
+void PCF8574_CallStats::dump(Print & out)
+{
+  for (uint8_t i = 0; i < _size; i++)
+  {
+    if (_sites[i].file == nullptr)
+    {
+      out.print("unknown");
+    }
+    else
+    {
+      out.print(_sites[i].file);
+      out.print(':');
+      out.print(_sites[i].line);
+    }
+    out.print('\t');
+    out.print(_sites[i].count);
+    out.print('\t');
+    out.println(_sites[i].busTime);
+  }
+  if (_dropped > 0)
+  {
+    out.print("dropped\t");
+    out.println(_dropped);
+  }
+}
+
+
+//  -- END OF FILE --
+
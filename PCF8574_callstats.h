@@ -0,0 +1,101 @@
+#pragma once
+//
+//    FILE: PCF8574_callstats.h
+//  AUTHOR: Rob Tillaart
+//    DATE: 2026-10-18
+// VERSION: 0.5.0
+// PURPOSE: Arduino library for PCF8574 - call site attribution of I2C traffic
+//     URL: https://github.com/RobTillaart/PCF8574
+
+
+#include "Arduino.h"
+
+
+//  number of call sites that can be tracked.
+//  RAM usage ~12 bytes per entry on AVR.
+#ifndef PCF8574_CALLSTATS_SIZE
+#define PCF8574_CALLSTATS_SIZE      16
+#endif
+
+
+struct PCF8574_CallSite
+{
+  const char * file;       //  nullptr == unknown caller
+  uint16_t     line;
+  uint32_t     count;      //  number of I2C transactions
+  uint32_t     busTime;    //  micros spent in these transactions
+};
+
+
+class PCF8574_CallStats
+{
+public:
+  PCF8574_CallStats();
+
+  //  set by PCF8574_CALL(), nullptr == unknown caller.
+  void    setCaller(const char * file, const uint16_t line);
+  const char * getCallerFile() const { return _file; };
+  uint16_t getCallerLine() const     { return _line; };
+  //  called by the device after every I2C transaction.
+  void    record(const uint32_t duration);
+
+  uint8_t size() const      { return _size; };
+  uint16_t dropped() const  { return _dropped; };
+  const PCF8574_CallSite & entry(const uint8_t index) const { return _sites[index]; };
+
+  void    reset();
+  //  file:line  count  busTime, one call site per line.
+  void    dump(Print & out);
+
+
+private:
+  PCF8574_CallSite _sites[PCF8574_CALLSTATS_SIZE];
+  uint8_t      _size {0};
+  uint16_t     _dropped {0};
+  const char * _file {nullptr};
+  uint16_t     _line {0};
+};
+
+
+//  sets the caller for the lifetime of the scope,
+//  restores the previous caller so scopes can be nested.
+class PCF8574_CallerScope
+{
+public:
+  PCF8574_CallerScope(PCF8574_CallStats * stats, const char * file, const uint16_t line)
+  : _stats {stats}
+  {
+    if (_stats == nullptr) return;
+    _file = _stats->getCallerFile();
+    _line = _stats->getCallerLine();
+    _stats->setCaller(file, line);
+  }
+  ~PCF8574_CallerScope()
+  {
+    if (_stats != nullptr) _stats->setCaller(_file, _line);
+  }
+
+private:
+  PCF8574_CallStats * _stats;
+  const char * _file {nullptr};
+  uint16_t     _line {0};
+};
+
+
+//  wraps an API call and attributes its I2C traffic to file:line of the caller.
+//  usage:  x = PCF8574_CALL(PCF, read8());
+//          PCF8574_CALL(PCF, write(3, HIGH));
+//  without PCF8574_CALLSTATS (whole build) it is just the call.
+#ifdef PCF8574_CALLSTATS
+#define PCF8574_CALL(dev, call)                                            \
+  ([&]() -> decltype((dev).call) {                                         \
+    PCF8574_CallerScope _pcf8574_scope((dev).getCallStats(), __FILE__, __LINE__); \
+    return (dev).call;                                                     \
+  }())
+#else
+#define PCF8574_CALL(dev, call)     ((dev).call)
+#endif
+
+
+//  -- END OF FILE --
+
@@ -0,0 +1,36 @@
+//
+//    FILE: PCF8574_clock.cpp
+//  AUTHOR: Rob Tillaart
+//    DATE: 2026-10-18
+// VERSION: 0.5.0
+// PURPOSE: Arduino library for PCF8574 - injectable clock
+//     URL: https://github.com/RobTillaart/PCF8574
+
+
+#include "PCF8574_clock.h"
+
+
+PCF8574_Clock * PCF8574_clock = nullptr;
+
+
+uint32_t PCF8574_Clock::micros()
+{
+  return ::micros();
+}
+
+
+uint32_t PCF8574_Clock::millis()
+{
+  return ::millis();
+}
+
+
+void PCF8574_Clock::delayMicros(uint32_t us)
+{
+  if (us >= 1000) delay(us / 1000);
+  delayMicroseconds(us % 1000);
+}
+
+
+//  -- END OF FILE --
+
@@ -0,0 +1,104 @@
+#pragma once
+//
+//    FILE: PCF8574_clock.h
+//  AUTHOR: Rob Tillaart
+//    DATE: 2026-10-18
+// VERSION: 0.5.0
+// PURPOSE: Arduino library for PCF8574 - injectable clock
+//     URL: https://github.com/RobTillaart/PCF8574
+//
+//  All timing of the library goes through PCF8574_micros(), PCF8574_millis()
+//  and PCF8574_delayMicros(). By default these call micros() and delay(),
+//  a simulation can install a virtual clock that advances instantly.
+
+
+#include "Arduino.h"
+
+
+class PCF8574_Clock
+{
+public:
+  virtual ~PCF8574_Clock() {};
+
+  virtual uint32_t micros();
+  virtual uint32_t millis();
+  virtual void     delayMicros(uint32_t us);
+  //  time spent by one iteration of a busy wait loop.
+  //  real time passes by itself, so default nothing.
+  virtual void     elapse(uint32_t us) { (void) us; };
+};
+
+
+//  time only moves by delayMicros(), elapse() and advance().
+//  millis are counted separately, so they do not wrap with micros (~71 minutes).
+class PCF8574_VirtualClock : public PCF8574_Clock
+{
+public:
+  explicit PCF8574_VirtualClock(const uint32_t start = 0) { set(start); };
+
+  uint32_t micros()                    { return _now; };
+  uint32_t millis()                    { return _ms; };
+  void     delayMicros(uint32_t us)    { advance(us); };
+  void     elapse(uint32_t us)         { advance(us); };
+  void     advance(const uint32_t us)
+  {
+    _now  += us;
+    _rest += us % 1000;
+    _ms   += us / 1000 + _rest / 1000;
+    _rest %= 1000;
+  };
+  void     set(const uint32_t now)
+  {
+    _now  = now;
+    _ms   = now / 1000;
+    _rest = now % 1000;
+  };
+
+private:
+  uint32_t _now  {0};
+  uint32_t _ms   {0};
+  uint16_t _rest {0};   //  micros not yet counted in _ms
+};
+
+
+//  nullptr == real time (default)
+extern PCF8574_Clock * PCF8574_clock;
+
+inline void PCF8574_setClock(PCF8574_Clock * clock) { PCF8574_clock = clock; }
+
+
+inline uint32_t PCF8574_micros()
+{
+  if (PCF8574_clock == nullptr) return micros();
+  return PCF8574_clock->micros();
+}
+
+
+inline uint32_t PCF8574_millis()
+{
+  if (PCF8574_clock == nullptr) return millis();
+  return PCF8574_clock->millis();
+}
+
+
+//  call in every iteration of a busy wait loop.
+inline void PCF8574_elapse(uint32_t us)
+{
+  if (PCF8574_clock != nullptr) PCF8574_clock->elapse(us);
+}
+
+
+inline void PCF8574_delayMicros(uint32_t us)
+{
+  if (PCF8574_clock != nullptr) PCF8574_clock->delayMicros(us);
+  else
+  {
+    //  delayMicroseconds() is 16 bit on AVR
+    if (us >= 1000) delay(us / 1000);
+    delayMicroseconds(us % 1000);
+  }
+}
+
+
+//  -- END OF FILE --
+
@@ -0,0 +1,121 @@
+#pragma once
+//
+//    FILE: PCF8574_hot.h
+//  AUTHOR: Rob Tillaart
+//    DATE: 2026-10-18
+// VERSION: 0.5.0
+// PURPOSE: Arduino library for PCF8574 - hot path functions
+//     URL: https://github.com/RobTillaart/PCF8574
+//
+//  Included by PCF8574.cpp (default) or by PCF8574.h
+//  when PCF8574_HEADER_ONLY is defined, see readme.md.
+//  Do not include this file directly.
+
+
+//  removed _wire->beginTransmission(_address);
+//  with    @100 KHz -> 265 micros()
+//  without @100 KHz -> 132 micros()
+//  without @400 KHz -> 52 micros()
+//  TODO    @800 KHz -> ??
+PCF8574_INLINE uint8_t PCF8574::read8()
+{
+#ifdef PCF8574_CALLSTATS
+  uint32_t start = 0;
+  if (_stats != nullptr) start = PCF8574_micros();
+#endif
+  PCF8574_TRACE1(read_start, _address);
+  uint8_t count = 0;
+  uint8_t value = 0;
+#ifdef PCF8574_SIM
+  if (_sim != nullptr)
+  {
+    count = _sim->read(_address, value);
+  }
+  else
+#endif
+  {
+    count = _wire->requestFrom(_address, (uint8_t)1);
+    if (count == 1) value = _wire->read();
+  }
+  if (count != 1)
+  {
+    _error = PCF8574_I2C_ERROR;  //  keep last value
+    PCF8574_TRACE2(error, _address, _error);
+  }
+  else
+  {
+    _dataIn = value;
+  }
+  PCF8574_TRACE2(read_end, _address, _dataIn);
+#ifdef PCF8574_CALLSTATS
+  if (_stats != nullptr) _stats->record(PCF8574_micros() - start);
+#endif
+  return _dataIn;
+}
+
+
+PCF8574_INLINE void PCF8574::write8(const uint8_t value)
+{
+#ifdef PCF8574_INTERLOCK
+  if ((_interlock != nullptr) && !_interlock->check(value))
+  {
+    _error = PCF8574_INTERLOCK_ERROR;  //  keep outputs
+    PCF8574_TRACE2(error, _address, _error);
+    return;
+  }
+#endif
+#ifdef PCF8574_CALLSTATS
+  uint32_t start = 0;
+  if (_stats != nullptr) start = PCF8574_micros();
+#endif
+  _dataOut = value;
+  PCF8574_TRACE2(write_start, _address, _dataOut);
+#ifdef PCF8574_SIM
+  if (_sim != nullptr)
+  {
+    _error = _sim->write(_address, &_dataOut, 1);
+  }
+  else
+#endif
+  {
+    _wire->beginTransmission(_address);
+    _wire->write(_dataOut);
+    _error = _wire->endTransmission();
+  }
+#ifdef PCF8574_RETAIN
+  if (_retainActive) _updateRetain();
+#endif
+  if (_error != 0) PCF8574_TRACE2(error, _address, _error);
+  PCF8574_TRACE2(write_end, _address, _error);
+#ifdef PCF8574_CALLSTATS
+  if (_stats != nullptr) _stats->record(PCF8574_micros() - start);
+#endif
+}
+
+
+PCF8574_INLINE void PCF8574::write(const uint8_t pin, const uint8_t value)
+{
+  if (pin > 7)
+  {
+    _error = PCF8574_PIN_ERROR;
+    return;
+  }
+  if (value == LOW)
+  {
+    write8(_dataOut & ~(1 << pin));
+  }
+  else
+  {
+    write8(_dataOut | (1 << pin));
+  }
+}
+
+
+PCF8574_INLINE void PCF8574::toggleMask(const uint8_t mask)
+{
+  PCF8574::write8(_dataOut ^ mask);
+}
+
+
+//  -- END OF FILE --
+
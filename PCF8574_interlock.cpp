@@ -0,0 +1,64 @@
+//
+//    FILE: PCF8574_interlock.cpp
+//  AUTHOR: Rob Tillaart
+//    DATE: 2026-10-18
+// VERSION: 0.5.0
+// PURPOSE: Arduino library for PCF8574 - safety interlock, allowed output states
+//     URL: https://github.com/RobTillaart/PCF8574
+
+
+#include "PCF8574_interlock.h"
+
+
+void PCF8574_Interlock::allowAll()
+{
+  for (uint8_t i = 0; i < 32; i++) _allowed[i] = 0xFF;
+}
+
+
+void PCF8574_Interlock::forbid(const uint8_t mask, const uint8_t value)
+{
+  _set(mask, value, false);
+}
+
+
+void PCF8574_Interlock::allow(const uint8_t mask, const uint8_t value)
+{
+  _set(mask, value, true);
+}
+
+
+uint16_t PCF8574_Interlock::allowedCount() const
+{
+  uint16_t count = 0;
+  for (uint8_t i = 0; i < 32; i++)
+  {
+    uint8_t b = _allowed[i];
+    while (b)
+    {
+      b &= b - 1;
+      count++;
+    }
+  }
+  return count;
+}
+
+
+/////////////////////////////////////////////////////////////
+//
+//  PRIVATE
+//
+void PCF8574_Interlock::_set(const uint8_t mask, const uint8_t value, const bool allowed)
+{
+  uint8_t v = value & mask;
+  for (uint16_t state = 0; state < 256; state++)
+  {
+    if ((state & mask) != v) continue;
+    if (allowed) _allowed[state >> 3] |=  (1 << (state & 7));
+    else         _allowed[state >> 3] &= ~(1 << (state & 7));
+  }
+}
+
+
+//  -- END OF FILE --
+
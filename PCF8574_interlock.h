@@ -0,0 +1,56 @@
+#pragma once
+//
+//    FILE: PCF8574_interlock.h
+//  AUTHOR: Rob Tillaart
+//    DATE: 2026-10-18
+// VERSION: 0.5.0
+// PURPOSE: Arduino library for PCF8574 - safety interlock, allowed output states
+//     URL: https://github.com/RobTillaart/PCF8574
+//
+//  Rules are compiled at setup into a table of the 256 output states,
+//  1 bit per state (32 bytes). Every write is checked with one lookup,
+//  a write to a forbidden state is blocked and counted.
+
+
+#include "Arduino.h"
+
+
+class PCF8574_Interlock
+{
+public:
+  PCF8574_Interlock() { allowAll(); };
+
+  void     allowAll();
+  //  forbid all states where (state & mask) == (value & mask)
+  //  e.g. both H-bridge legs on (active LOW):  forbid(0x03, 0x00);
+  void     forbid(const uint8_t mask, const uint8_t value);
+  //  allow all states where (state & mask) == (value & mask)
+  void     allow(const uint8_t mask, const uint8_t value);
+
+  bool     isAllowed(const uint8_t state) const
+  {
+    return (_allowed[state >> 3] >> (state & 7)) & 1;
+  };
+  //  isAllowed() + count violation
+  bool     check(const uint8_t state)
+  {
+    if (isAllowed(state)) return true;
+    _violations++;
+    return false;
+  };
+  uint16_t allowedCount() const;
+
+  uint32_t violations() const { return _violations; };
+  void     resetViolations()  { _violations = 0; };
+
+
+private:
+  uint8_t  _allowed[32];
+  uint32_t _violations {0};
+
+  void     _set(const uint8_t mask, const uint8_t value, const bool allowed);
+};
+
+
+//  -- END OF FILE --
+
@@ -0,0 +1,373 @@
+//
+//    FILE: PCF8574_logic.cpp
+//  AUTHOR: Rob Tillaart
+//    DATE: 2026-10-18
+// VERSION: 0.5.0
+// PURPOSE: Arduino library for PCF8574 - compiled combinational logic over a bank
+//     URL: https://github.com/RobTillaart/PCF8574
+
+
+#include "PCF8574_logic.h"
+
+
+//  PROGRAM, a group per set of rules that share their structure:
+//    LOAD   count (device shift mask)[count]   push OR of rotl(in[device], shift) & mask
+//    NOT                                       top = ~top
+//    AND, OR, XOR                              pop b, top = top op b
+//    STORE  device mask                        pop, out[device] = top for the bits in mask
+//  bit k of every word is the lane of output pin k, a LOAD rotates
+//  input pin j of every rule into the lane k of its output.
+//  NOT .. XOR are also the operator tokens of the compiler.
+static const uint8_t PCF8574_LOGIC_OP_LOAD  = 0x01;
+static const uint8_t PCF8574_LOGIC_OP_NOT   = 0x02;
+static const uint8_t PCF8574_LOGIC_OP_AND   = 0x03;
+static const uint8_t PCF8574_LOGIC_OP_OR    = 0x04;
+static const uint8_t PCF8574_LOGIC_OP_XOR   = 0x05;
+static const uint8_t PCF8574_LOGIC_OP_STORE = 0x06;
+
+static const uint16_t PCF8574_LOGIC_NONE    = 0xFFFF;
+
+
+PCF8574_Logic::PCF8574_Logic()
+{
+  clear();
+}
+
+
+void PCF8574_Logic::clear()
+{
+  _size  = 0;
+  _rules = 0;
+  _error = PCF8574_LOGIC_OK;
+  _position = 0;
+}
+
+
+bool PCF8574_Logic::addRule(const uint8_t device, const uint8_t pin, const char * expression)
+{
+  _error = PCF8574_LOGIC_OK;
+  _position = 0;
+  if ((device >= PCF8574_BANK_SIZE) || (pin > 7)) return _fail(PCF8574_LOGIC_SYNTAX);
+
+  _start = expression;
+  _p = expression;
+  _depth = 0;
+  _count = 0;
+  _stack = 0;
+  _maxStack = 0;
+  if (! _expr()) return false;
+  _skip();
+  if (*_p != 0) return _fail(PCF8574_LOGIC_SYNTAX);
+
+  uint16_t group = _find(device, 1 << pin);
+  if (group != PCF8574_LOGIC_NONE) return _share(group, pin);
+  return _emit(device, pin);
+}
+
+
+void PCF8574_Logic::evaluate(const uint8_t * in, uint8_t * out) const
+{
+  uint8_t  stack[PCF8574_LOGIC_STACK];
+  uint8_t  top = 0;
+  uint16_t i = 0;
+  while (i < _size)
+  {
+    switch (_program[i++])
+    {
+      case PCF8574_LOGIC_OP_LOAD:
+      {
+        uint8_t count = _program[i++];
+        uint8_t word = 0;
+        for (uint8_t k = 0; k < count; k++, i += 3)
+        {
+          uint8_t value = in[_program[i]];
+          uint8_t shift = _program[i + 1];
+          word |= (uint8_t)((value << shift) | (value >> (8 - shift))) & _program[i + 2];
+        }
+        stack[top++] = word;
+        break;
+      }
+      case PCF8574_LOGIC_OP_NOT:
+        stack[top - 1] = ~stack[top - 1];
+        break;
+      case PCF8574_LOGIC_OP_AND:
+        top--;
+        stack[top - 1] &= stack[top];
+        break;
+      case PCF8574_LOGIC_OP_OR:
+        top--;
+        stack[top - 1] |= stack[top];
+        break;
+      case PCF8574_LOGIC_OP_XOR:
+        top--;
+        stack[top - 1] ^= stack[top];
+        break;
+      case PCF8574_LOGIC_OP_STORE:
+      {
+        top--;
+        uint8_t device = _program[i];
+        uint8_t mask = _program[i + 1];
+        out[device] = (out[device] & ~mask) | (stack[top] & mask);
+        i += 2;
+        break;
+      }
+    }
+  }
+}
+
+
+/////////////////////////////////////////////////////////////
+//
+//  PRIVATE - PARSER, emits the rule in postfix
+//
+void PCF8574_Logic::_skip()
+{
+  while ((*_p == ' ') || (*_p == '\t')) _p++;
+}
+
+
+//  expr := xor ('|' xor)*
+bool PCF8574_Logic::_expr()
+{
+  if (! _xor()) return false;
+  _skip();
+  while (*_p == '|')
+  {
+    _p++;
+    if (! _xor() || ! _token(PCF8574_LOGIC_OP_OR)) return false;
+    _skip();
+  }
+  return true;
+}
+
+
+//  xor := and ('^' and)*
+bool PCF8574_Logic::_xor()
+{
+  if (! _and()) return false;
+  _skip();
+  while (*_p == '^')
+  {
+    _p++;
+    if (! _and() || ! _token(PCF8574_LOGIC_OP_XOR)) return false;
+    _skip();
+  }
+  return true;
+}
+
+
+//  and := unary ('&' unary)*
+bool PCF8574_Logic::_and()
+{
+  if (! _unary()) return false;
+  _skip();
+  while (*_p == '&')
+  {
+    _p++;
+    if (! _unary() || ! _token(PCF8574_LOGIC_OP_AND)) return false;
+    _skip();
+  }
+  return true;
+}
+
+
+//  unary := '!' unary | '(' expr ')' | device '.' pin
+bool PCF8574_Logic::_unary()
+{
+  _skip();
+  if ((*_p == '!') || (*_p == '('))
+  {
+    if (_depth >= PCF8574_LOGIC_DEPTH) return _fail(PCF8574_LOGIC_NESTING);
+    _depth++;
+    bool rv = false;
+    if (*_p == '!')
+    {
+      _p++;
+      rv = _unary() && _token(PCF8574_LOGIC_OP_NOT);
+    }
+    else
+    {
+      _p++;
+      rv = _expr();
+      if (rv)
+      {
+        _skip();
+        if (*_p != ')') return _fail(PCF8574_LOGIC_SYNTAX);
+        _p++;
+      }
+    }
+    _depth--;
+    return rv;
+  }
+  if ((*_p < '0') || (*_p > '9')) return _fail(PCF8574_LOGIC_SYNTAX);
+  uint8_t device = 0;
+  while ((*_p >= '0') && (*_p <= '9'))
+  {
+    device = device * 10 + (*_p - '0');
+    if (device >= PCF8574_BANK_SIZE) return _fail(PCF8574_LOGIC_SYNTAX);
+    _p++;
+  }
+  if ((_p[0] != '.') || (_p[1] < '0') || (_p[1] > '7')) return _fail(PCF8574_LOGIC_SYNTAX);
+  uint8_t pin = _p[1] - '0';
+  _p += 2;
+  return _token(0x80 + device * 8 + pin);
+}
+
+
+//  tracks the depth of the evaluation stack.
+bool PCF8574_Logic::_token(const uint8_t token)
+{
+  if (_count >= PCF8574_LOGIC_TOKENS) return _fail(PCF8574_LOGIC_COMPLEX);
+  _code[_count++] = token;
+  if (token & 0x80)
+  {
+    if (_stack >= PCF8574_LOGIC_STACK) return _fail(PCF8574_LOGIC_COMPLEX);
+    _stack++;
+  }
+  else if (token != PCF8574_LOGIC_OP_NOT)
+  {
+    _stack--;
+  }
+  return true;
+}
+
+
+bool PCF8574_Logic::_fail(const int error)
+{
+  _error = error;
+  _position = _p - _start;
+  return false;
+}
+
+
+/////////////////////////////////////////////////////////////
+//
+//  PRIVATE - CODE GENERATION
+//
+//  last group of the output device with the structure of the rule that
+//  does not write the lane yet, and no later group writes the lane,
+//  so the last rule added for an output pin still wins.
+uint16_t PCF8574_Logic::_find(const uint8_t device, const uint8_t lane) const
+{
+  uint16_t found = PCF8574_LOGIC_NONE;
+  uint16_t i = 0;
+  while (i < _size)
+  {
+    uint16_t group = i;
+    bool    same = true;
+    uint8_t k = 0;
+    while (_program[i] != PCF8574_LOGIC_OP_STORE)
+    {
+      uint8_t op = _program[i];
+      if (op == PCF8574_LOGIC_OP_LOAD)
+      {
+        if ((k >= _count) || ((_code[k] & 0x80) == 0)) same = false;
+        i += 2 + 3 * _program[i + 1];
+      }
+      else
+      {
+        if ((k >= _count) || (_code[k] != op)) same = false;
+        i++;
+      }
+      k++;
+    }
+    if (k != _count) same = false;
+    if (_program[i + 1] == device)
+    {
+      if (_program[i + 2] & lane) found = PCF8574_LOGIC_NONE;
+      else if (same) found = group;
+    }
+    i += 3;
+  }
+  return found;
+}
+
+
+//  adds the rule to the lane of pin in an existing group.
+//  a LOAD gets a new (device shift) entry only if no rule in
+//  the group uses that combination yet.
+bool PCF8574_Logic::_share(const uint16_t group, const uint8_t pin)
+{
+  uint8_t lane = 1 << pin;
+  //  two passes, first the size so a full program is not changed.
+  for (uint8_t pass = 0; pass < 2; pass++)
+  {
+    uint16_t extra = 0;
+    uint16_t i = group;
+    uint8_t  k = 0;
+    while (_program[i] != PCF8574_LOGIC_OP_STORE)
+    {
+      if (_program[i] != PCF8574_LOGIC_OP_LOAD)
+      {
+        i++;
+        k++;
+        continue;
+      }
+      uint8_t input = _code[k++] & 0x7F;
+      uint8_t device = input >> 3;
+      uint8_t shift = (pin - input) & 7;
+      uint8_t count = _program[i + 1];
+      uint16_t entry = i + 2;
+      uint16_t end = entry + 3 * count;
+      while ((entry < end) && ((_program[entry] != device) || (_program[entry + 1] != shift))) entry += 3;
+      if (entry < end)
+      {
+        if (pass == 1) _program[entry + 2] |= lane;
+      }
+      else if (pass == 0)
+      {
+        extra += 3;
+      }
+      else
+      {
+        memmove(&_program[end + 3], &_program[end], _size - end);
+        _size += 3;
+        _program[end]     = device;
+        _program[end + 1] = shift;
+        _program[end + 2] = lane;
+        _program[i + 1]   = count + 1;
+        end += 3;
+      }
+      i = end;
+    }
+    if ((pass == 0) && (_size + extra > PCF8574_LOGIC_SIZE)) return _fail(PCF8574_LOGIC_FULL);
+    if (pass == 1) _program[i + 2] |= lane;
+  }
+  _rules++;
+  return true;
+}
+
+
+//  appends a new group for the rule.
+bool PCF8574_Logic::_emit(const uint8_t device, const uint8_t pin)
+{
+  uint16_t length = 3;
+  for (uint8_t k = 0; k < _count; k++) length += (_code[k] & 0x80) ? 5 : 1;
+  if (_size + length > PCF8574_LOGIC_SIZE) return _fail(PCF8574_LOGIC_FULL);
+
+  for (uint8_t k = 0; k < _count; k++)
+  {
+    uint8_t token = _code[k];
+    if (token & 0x80)
+    {
+      uint8_t input = token & 0x7F;
+      _program[_size++] = PCF8574_LOGIC_OP_LOAD;
+      _program[_size++] = 1;
+      _program[_size++] = input >> 3;
+      _program[_size++] = (pin - input) & 7;
+      _program[_size++] = 1 << pin;
+    }
+    else
+    {
+      _program[_size++] = token;
+    }
+  }
+  _program[_size++] = PCF8574_LOGIC_OP_STORE;
+  _program[_size++] = device;
+  _program[_size++] = 1 << pin;
+  _rules++;
+  return true;
+}
+
+
+//  -- END OF FILE --
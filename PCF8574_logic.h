@@ -0,0 +1,108 @@
+#pragma once
+//
+//    FILE: PCF8574_logic.h
+//  AUTHOR: Rob Tillaart
+//    DATE: 2026-10-18
+// VERSION: 0.5.0
+// PURPOSE: Arduino library for PCF8574 - compiled combinational logic over a bank
+//     URL: https://github.com/RobTillaart/PCF8574
+//
+//  Rules like "0.1 & !0.5" (device.pin) are compiled at setup into a
+//  straight line program of AND, OR, XOR and NOT on whole port words.
+//  The program is bit sliced over the outputs, bit k of every word is the
+//  lane of output pin k and an input pin is rotated into that lane.
+//  Rules for pins of one output device with the same structure share one
+//  program, e.g. the 8 rules "3.k = 0.k & !1.k" are 5 word operations.
+//  XOR is a native operation, NOT does not expand the expression.
+
+
+#include "PCF8574_bank.h"
+
+
+//  bytes of compiled rules, a pin is 5 bytes, an operator 1 and the
+//  output 3, a rule that shares a program 0 or 3 bytes per pin.
+#ifndef PCF8574_LOGIC_SIZE
+#if defined(__AVR__)
+#define PCF8574_LOGIC_SIZE          128
+#else
+#define PCF8574_LOGIC_SIZE          1024
+#endif
+#endif
+
+#ifndef PCF8574_LOGIC_TOKENS
+#define PCF8574_LOGIC_TOKENS        32      //  max pins + operators per rule
+#endif
+
+#ifndef PCF8574_LOGIC_STACK
+#define PCF8574_LOGIC_STACK         8       //  max words on the evaluation stack
+#endif
+
+//  max nesting of ( and !
+#ifndef PCF8574_LOGIC_DEPTH
+#define PCF8574_LOGIC_DEPTH         8
+#endif
+
+
+//  ERROR CODES
+#define PCF8574_LOGIC_OK            0x00
+#define PCF8574_LOGIC_SYNTAX        0x01
+#define PCF8574_LOGIC_COMPLEX       0x02    //  too many tokens or stack words
+#define PCF8574_LOGIC_FULL          0x03    //  PCF8574_LOGIC_SIZE exceeded
+#define PCF8574_LOGIC_NESTING       0x04    //  PCF8574_LOGIC_DEPTH exceeded
+
+
+class PCF8574_Logic
+{
+public:
+  PCF8574_Logic();
+
+  //  output = expression, pins are "device.pin", e.g. "0.1 & !(0.5 | 1.2)"
+  //  operators in order of precedence: ! & ^ |  and ( )
+  bool     addRule(const uint8_t device, const uint8_t pin, const char * expression);
+  void     clear();
+  //  evaluates all rules, in and out hold the bytes of the devices used.
+  //  a rule sees no results of other rules, for the same output pin
+  //  the last rule added wins.
+  void     evaluate(const uint8_t * in, uint8_t * out) const;
+
+  uint16_t rules() const { return _rules; };
+  //  bytes of PCF8574_LOGIC_SIZE used.
+  uint16_t size() const  { return _size; };
+  //  error of the last addRule(), position of a syntax error.
+  int      lastError() const { return _error; };
+  uint8_t  errorPosition() const { return _position; };
+
+
+private:
+  uint8_t   _program[PCF8574_LOGIC_SIZE];
+  uint16_t  _size {0};
+  uint16_t  _rules {0};
+  int       _error {PCF8574_LOGIC_OK};
+  uint8_t   _position {0};
+
+  //  COMPILER, the rule in postfix, a pin is 0x80 + device * 8 + pin.
+  uint8_t   _code[PCF8574_LOGIC_TOKENS];
+  uint8_t   _count {0};
+  uint8_t   _stack {0};
+  uint8_t   _maxStack {0};
+
+  const char * _start {nullptr};
+  const char * _p {nullptr};
+  uint8_t   _depth {0};
+
+  void     _skip();
+  bool     _expr();
+  bool     _xor();
+  bool     _and();
+  bool     _unary();
+
+  bool     _token(const uint8_t token);
+  bool     _fail(const int error);
+  uint16_t _find(const uint8_t device, const uint8_t lane) const;
+  bool     _share(const uint16_t group, const uint8_t pin);
+  bool     _emit(const uint8_t device, const uint8_t pin);
+};
+
+
+//  -- END OF FILE --
+
@@ -0,0 +1,236 @@
+//
+//    FILE: PCF8574_modbus.cpp
+//  AUTHOR: Rob Tillaart
+//    DATE: 2026-10-18
+// VERSION: 0.5.0
+// PURPOSE: Arduino library for PCF8574 - Modbus RTU slave for a bank of devices
+//     URL: https://github.com/RobTillaart/PCF8574
+
+
+#include "PCF8574_modbus.h"
+
+
+PCF8574_Modbus::PCF8574_Modbus(PCF8574_Bank * bank, const uint8_t slaveID)
+: _bank {bank}, _slaveID {slaveID}
+{
+}
+
+
+void PCF8574_Modbus::begin(Stream * stream, const uint32_t baudrate)
+{
+  _stream = stream;
+  _length = 0;
+  _overflow = false;
+  //  3.5 characters of 11 bits, fixed 1750 us above 19200 baud (spec).
+  _frameGap = 1750;
+  if ((baudrate > 0) && (baudrate <= 19200)) _frameGap = 38500000UL / baudrate;
+}
+
+
+bool PCF8574_Modbus::poll()
+{
+  if (_stream == nullptr) return false;
+  while (_stream->available() > 0)
+  {
+    uint8_t c = _stream->read();
+    if (_length < PCF8574_MODBUS_BUFFER) _buffer[_length++] = c;
+    else _overflow = true;
+    _lastByte = PCF8574_micros();
+  }
+  if (_length == 0) return false;
+  if (PCF8574_micros() - _lastByte < _frameGap) return false;
+
+  //  frame complete, a frame that did not fit is not for us anyway.
+  bool handled = false;
+  if (! _overflow)
+  {
+    uint8_t response[PCF8574_MODBUS_BUFFER];
+    uint8_t n = process(_buffer, _length, response);
+    if (n > 0) _stream->write(response, n);
+    handled = true;
+  }
+  _length = 0;
+  _overflow = false;
+  return handled;
+}
+
+
+uint8_t PCF8574_Modbus::process(const uint8_t * request, const uint8_t length, uint8_t * response)
+{
+  if (length < 4) return 0;
+  uint16_t crc = request[length - 2] | (request[length - 1] << 8);
+  if (crc16(request, length - 2) != crc)
+  {
+    _crcErrors++;
+    return 0;
+  }
+  uint8_t id = request[0];
+  if ((id != _slaveID) && (id != 0)) return 0;
+  _requests++;
+
+  uint8_t n = 0;
+  switch (request[1])
+  {
+    case PCF8574_MB_READ_COILS:
+    case PCF8574_MB_READ_INPUTS:
+      if (id == 0) return 0;  //  no broadcast reads
+      if (length != 8) n = _exception(request, response, PCF8574_MB_ILLEGAL_VALUE);
+      else n = _readBits(request, response, request[1] == PCF8574_MB_READ_INPUTS);
+      break;
+    case PCF8574_MB_WRITE_COIL:
+    case PCF8574_MB_WRITE_COILS:
+      n = _writeCoils(request, length, response);
+      break;
+    default:
+      n = _exception(request, response, PCF8574_MB_ILLEGAL_FUNCTION);
+      break;
+  }
+  if (id == 0) return 0;  //  broadcast, no response
+  return n;
+}
+
+
+uint16_t PCF8574_Modbus::crc16(const uint8_t * data, const uint8_t length)
+{
+  return PCF8574_crc16(data, length);
+}
+
+
+/////////////////////////////////////////////////////////////
+//
+//  PRIVATE
+//
+uint8_t PCF8574_Modbus::_readBits(const uint8_t * request, uint8_t * response, const bool inputs)
+{
+  uint16_t start    = (request[2] << 8) | request[3];
+  uint16_t quantity = (request[4] << 8) | request[5];
+  if ((quantity == 0) || (quantity > 2000))
+  {
+    return _exception(request, response, PCF8574_MB_ILLEGAL_VALUE);
+  }
+  if ((uint32_t)start + quantity > _bank->size() * 8U)
+  {
+    return _exception(request, response, PCF8574_MB_ILLEGAL_ADDRESS);
+  }
+
+  uint8_t first = start / 8;
+  uint8_t last  = (start + quantity - 1) / 8;
+  if (inputs)
+  {
+    //  one read per device.
+    for (uint8_t d = first; d <= last; d++)
+    {
+      PCF8574 * dev = _bank->device(d);
+      dev->read8();
+      if (dev->lastError() != PCF8574_OK)
+      {
+        return _exception(request, response, PCF8574_MB_DEVICE_FAILURE);
+      }
+    }
+    _bank->publish();
+  }
+
+  uint8_t bytes = (quantity + 7) / 8;
+  response[0] = request[0];
+  response[1] = request[1];
+  response[2] = bytes;
+  for (uint8_t i = 0; i < bytes; i++) response[3 + i] = 0;
+  for (uint16_t k = 0; k < quantity; k++)
+  {
+    uint16_t bit = start + k;
+    PCF8574 * dev = _bank->device(bit / 8);
+    uint8_t value = inputs ? dev->value() : dev->valueOut();
+    if (value & (1 << (bit & 7))) response[3 + k / 8] |= (1 << (k & 7));
+  }
+  return _finish(response, 3 + bytes);
+}
+
+
+uint8_t PCF8574_Modbus::_writeCoils(const uint8_t * request, const uint8_t length, uint8_t * response)
+{
+  //  check the length before any operand is decoded.
+  bool multiple = (request[1] == PCF8574_MB_WRITE_COILS);
+  if ((! multiple && (length != 8)) || (multiple && (length < 9)))
+  {
+    return _exception(request, response, PCF8574_MB_ILLEGAL_VALUE);
+  }
+
+  uint16_t start = (request[2] << 8) | request[3];
+  uint16_t quantity = 1;
+  uint8_t  single = 0;
+  const uint8_t * data = &single;
+
+  if (! multiple)
+  {
+    uint16_t value = (request[4] << 8) | request[5];
+    if ((value != 0xFF00) && (value != 0x0000))
+    {
+      return _exception(request, response, PCF8574_MB_ILLEGAL_VALUE);
+    }
+    single = (value == 0xFF00) ? 1 : 0;
+  }
+  else
+  {
+    quantity = (request[4] << 8) | request[5];
+    if ((quantity == 0) || (quantity > 1968)
+       || (request[6] != (quantity + 7) / 8) || (length != 9 + request[6]))
+    {
+      return _exception(request, response, PCF8574_MB_ILLEGAL_VALUE);
+    }
+    data = &request[7];
+  }
+  if ((uint32_t)start + quantity > _bank->size() * 8U)
+  {
+    return _exception(request, response, PCF8574_MB_ILLEGAL_ADDRESS);
+  }
+
+  //  at most one write per device, only if its outputs change.
+  uint8_t first = start / 8;
+  uint8_t last  = (start + quantity - 1) / 8;
+  bool    failed = false;
+  for (uint8_t d = first; d <= last; d++)
+  {
+    PCF8574 * dev = _bank->device(d);
+    uint8_t value = dev->valueOut();
+    for (uint8_t pin = 0; pin < 8; pin++)
+    {
+      uint16_t bit = d * 8 + pin;
+      if ((bit < start) || (bit >= start + quantity)) continue;
+      uint16_t k = bit - start;
+      if (data[k / 8] & (1 << (k & 7))) value |= (1 << pin);
+      else                              value &= ~(1 << pin);
+    }
+    if (value == dev->valueOut()) continue;
+    dev->write8(value);
+    if (dev->lastError() != PCF8574_OK) failed = true;
+  }
+  _bank->publish();
+  if (failed) return _exception(request, response, PCF8574_MB_DEVICE_FAILURE);
+
+  //  echo function, address and value / quantity.
+  for (uint8_t i = 0; i < 6; i++) response[i] = request[i];
+  return _finish(response, 6);
+}
+
+
+uint8_t PCF8574_Modbus::_exception(const uint8_t * request, uint8_t * response, const uint8_t code)
+{
+  _exceptions++;
+  response[0] = request[0];
+  response[1] = request[1] | 0x80;
+  response[2] = code;
+  return _finish(response, 3);
+}
+
+
+uint8_t PCF8574_Modbus::_finish(uint8_t * response, const uint8_t length)
+{
+  uint16_t crc = crc16(response, length);
+  response[length]     = crc & 0xFF;
+  response[length + 1] = crc >> 8;
+  return length + 2;
+}
+
+
+//  -- END OF FILE --
+
@@ -0,0 +1,86 @@
+#pragma once
+//
+//    FILE: PCF8574_modbus.h
+//  AUTHOR: Rob Tillaart
+//    DATE: 2026-10-18
+// VERSION: 0.5.0
+// PURPOSE: Arduino library for PCF8574 - Modbus RTU slave for a bank of devices
+//     URL: https://github.com/RobTillaart/PCF8574
+//
+//  Coils           = outputs of the bank, coil n = device n / 8, pin n % 8.
+//  Discrete inputs = inputs of the bank, same numbering.
+//  Supported function codes 01, 02, 05, 15 (0x0F).
+
+
+#include "PCF8574_bank.h"
+
+
+#ifndef PCF8574_MODBUS_BUFFER
+#define PCF8574_MODBUS_BUFFER       64
+#endif
+
+//  FUNCTION CODES
+#define PCF8574_MB_READ_COILS       0x01
+#define PCF8574_MB_READ_INPUTS      0x02
+#define PCF8574_MB_WRITE_COIL       0x05
+#define PCF8574_MB_WRITE_COILS      0x0F
+
+//  EXCEPTION CODES
+#define PCF8574_MB_ILLEGAL_FUNCTION 0x01
+#define PCF8574_MB_ILLEGAL_ADDRESS  0x02
+#define PCF8574_MB_ILLEGAL_VALUE    0x03
+#define PCF8574_MB_DEVICE_FAILURE   0x04
+
+
+class PCF8574_Modbus
+{
+public:
+  PCF8574_Modbus(PCF8574_Bank * bank, const uint8_t slaveID);
+
+  void     setSlaveID(const uint8_t slaveID) { _slaveID = slaveID; };
+  uint8_t  getSlaveID() const { return _slaveID; };
+
+  //  STREAM
+  //  baudrate sets the 3.5 character frame gap.
+  void     begin(Stream * stream, const uint32_t baudrate);
+  //  call from loop(), handles a request once the frame gap has passed.
+  //  returns true if a request was handled.
+  bool     poll();
+
+  //  TRANSPORT INDEPENDENT
+  //  handles one request frame (including CRC),
+  //  fills response, returns its length, 0 == no response.
+  uint8_t  process(const uint8_t * request, const uint8_t length, uint8_t * response);
+
+  //  Modbus CRC16, polynomial 0xA001, sent low byte first.
+  static uint16_t crc16(const uint8_t * data, const uint8_t length);
+
+  uint32_t requests() const   { return _requests; };
+  uint32_t crcErrors() const  { return _crcErrors; };
+  uint32_t exceptions() const { return _exceptions; };
+
+
+private:
+  PCF8574_Bank * _bank;
+  uint8_t   _slaveID;
+
+  Stream *  _stream {nullptr};
+  uint32_t  _frameGap {1750};
+  uint32_t  _lastByte {0};
+  uint8_t   _buffer[PCF8574_MODBUS_BUFFER];
+  uint8_t   _length {0};
+  bool      _overflow {false};
+
+  uint32_t  _requests {0};
+  uint32_t  _crcErrors {0};
+  uint32_t  _exceptions {0};
+
+  uint8_t   _readBits(const uint8_t * request, uint8_t * response, const bool inputs);
+  uint8_t   _writeCoils(const uint8_t * request, const uint8_t length, uint8_t * response);
+  uint8_t   _exception(const uint8_t * request, uint8_t * response, const uint8_t code);
+  uint8_t   _finish(uint8_t * response, const uint8_t length);
+};
+
+
+//  -- END OF FILE --
+
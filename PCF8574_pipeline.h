@@ -0,0 +1,224 @@
+#pragma once
+//
+//    FILE: PCF8574_pipeline.h
+//  AUTHOR: Rob Tillaart
+//    DATE: 2026-10-18
+// VERSION: 0.5.0
+// PURPOSE: Arduino library for PCF8574 - compile time input processing pipeline
+//     URL: https://github.com/RobTillaart/PCF8574
+//
+//  PCF8574_Pipeline<Source, Stage...> composes an input path at compile time:
+//
+//    void onKey(uint8_t pin, bool rising) { ... }
+//    PCF8574_Pipeline<PCF8574_PipeSource<PCF8574>,
+//                     PCF8574_PipeInvert<0xFF>,
+//                     PCF8574_PipeDebounce,
+//                     PCF8574_PipeEdges,
+//                     PCF8574_PipeDispatch<onKey> > keys(PCF);
+//    keys.update();    //  from loop()
+//
+//  No virtual functions, no buffers between stages, the stages inline
+//  into one function per configuration. Header only.
+
+
+#include "PCF8574_bank.h"
+
+
+//  the data passed from stage to stage, W = word of the source.
+template <class W>
+struct PCF8574_PipeData
+{
+  W value;
+  W rising;
+  W falling;
+};
+
+
+//////////////////////////////////////////////////////////////
+//
+//  SOURCES
+//
+//  any port with the expander port concept, see PCF8574_port.h
+template <class T>
+class PCF8574_PipeSource
+{
+public:
+  typedef uint16_t Word;
+  explicit PCF8574_PipeSource(T & port) : _port(port) {};
+  Word read() { return _port.portRead(); };
+private:
+  T & _port;
+};
+
+
+//  a PCF8574 reads an 8 bit word.
+template <>
+class PCF8574_PipeSource<PCF8574>
+{
+public:
+  typedef uint8_t Word;
+  explicit PCF8574_PipeSource(PCF8574 & port) : _port(port) {};
+  Word read() { return _port.read8(); };
+private:
+  PCF8574 & _port;
+};
+
+
+//  first N (1..4) devices of a bank, device i in bits 8i..8i+7.
+template <uint8_t N> struct PCF8574_PipeBankWord     { typedef uint32_t type; };
+template <>          struct PCF8574_PipeBankWord<1>  { typedef uint8_t  type; };
+template <>          struct PCF8574_PipeBankWord<2>  { typedef uint16_t type; };
+
+template <uint8_t N>
+class PCF8574_PipeBankSource
+{
+  static_assert((N >= 1) && (N <= 4), "PCF8574_PipeBankSource: N = 1..4");
+public:
+  typedef typename PCF8574_PipeBankWord<N>::type Word;
+  explicit PCF8574_PipeBankSource(PCF8574_Bank & bank) : _bank(bank) {};
+  Word read()
+  {
+    Word w = 0;
+    for (uint8_t i = 0; i < N; i++) w |= (Word)_bank.read8(i) << (8 * i);
+    return w;
+  };
+private:
+  PCF8574_Bank & _bank;
+};
+
+
+//////////////////////////////////////////////////////////////
+//
+//  STAGES
+//
+//  A stage is a class with a member template Stage<W> that has
+//    void process(PCF8574_PipeData<W> & d);
+//  and only the state it needs.
+
+
+//  polarity fix, e.g. buttons to GND read LOW when pressed.
+template <uint32_t MASK>
+struct PCF8574_PipeInvert
+{
+  template <class W>
+  struct Stage
+  {
+    void process(PCF8574_PipeData<W> & d) { d.value ^= (W)MASK; };
+  };
+};
+
+
+//  bit parallel debounce with 2 bit vertical counters,
+//  a bit changes after 4 equal samples (P. Dannegger).
+struct PCF8574_PipeDebounce
+{
+  template <class W>
+  struct Stage
+  {
+    W state {0};
+    W ct0 {(W)~0};
+    W ct1 {(W)~0};
+    void process(PCF8574_PipeData<W> & d)
+    {
+      W delta = d.value ^ state;
+      ct0 = ~(ct0 & delta);
+      ct1 = ct0 ^ (ct1 & delta);
+      delta &= ct0 & ct1;
+      state ^= delta;
+      d.value = state;
+    };
+  };
+};
+
+
+//  sets rising and falling bits compared to the previous value.
+struct PCF8574_PipeEdges
+{
+  template <class W>
+  struct Stage
+  {
+    W last {0};
+    void process(PCF8574_PipeData<W> & d)
+    {
+      W changed = d.value ^ last;
+      d.rising  = changed & d.value;
+      d.falling = changed & last;
+      last = d.value;
+    };
+  };
+};
+
+
+//  calls HANDLER(pin, rising) for every edge, pin 0 = bit 0.
+template <void (*HANDLER)(uint8_t pin, bool rising)>
+struct PCF8574_PipeDispatch
+{
+  template <class W>
+  struct Stage
+  {
+    void process(PCF8574_PipeData<W> & d)
+    {
+      W edges = d.rising | d.falling;
+      for (uint8_t pin = 0; edges != 0; pin++, edges >>= 1)
+      {
+        if (edges & 1) HANDLER(pin, (d.rising >> pin) & 1);
+      }
+    };
+  };
+};
+
+
+//////////////////////////////////////////////////////////////
+//
+//  PIPELINE
+//
+template <class W, class... S>
+struct PCF8574_PipeStages
+{
+  void run(PCF8574_PipeData<W> &) {};
+};
+
+
+template <class W, class H, class... S>
+struct PCF8574_PipeStages<W, H, S...> : H::template Stage<W>, PCF8574_PipeStages<W, S...>
+{
+  inline void run(PCF8574_PipeData<W> & d)
+  {
+    H::template Stage<W>::process(d);
+    PCF8574_PipeStages<W, S...>::run(d);
+  };
+};
+
+
+template <class Source, class... S>
+class PCF8574_Pipeline : private PCF8574_PipeStages<typename Source::Word, S...>
+{
+public:
+  typedef typename Source::Word Word;
+
+  template <class T>
+  explicit PCF8574_Pipeline(T & source) : _source(source) {};
+
+  //  one read and all stages, returns the processed value.
+  inline Word update()
+  {
+    _data.value   = _source.read();
+    _data.rising  = 0;
+    _data.falling = 0;
+    PCF8574_PipeStages<Word, S...>::run(_data);
+    return _data.value;
+  };
+
+  Word value() const   { return _data.value; };
+  Word rising() const  { return _data.rising; };
+  Word falling() const { return _data.falling; };
+
+
+private:
+  Source _source;
+  PCF8574_PipeData<Word> _data {0, 0, 0};
+};
+
+
+//  -- END OF FILE --
+
@@ -0,0 +1,113 @@
+#pragma once
+//
+//    FILE: PCF8574_port.h
+//  AUTHOR: Rob Tillaart
+//    DATE: 2026-10-18
+// VERSION: 0.5.0
+// PURPOSE: Arduino library for PCF8574 - common IO expander port interface
+//     URL: https://github.com/RobTillaart/PCF8574
+//
+//  A port is an 8 or 16 bit IO expander (PCF8574, PCF8575, MCP23008, ...)
+//  that implements the port concept:
+//
+//    static constexpr uint8_t  portWidth();          //  8 or 16
+//    static constexpr uint16_t portCapabilities();   //  EXPANDER_CAP_xxx
+//    uint16_t portRead();                            //  bus access
+//    void     portWrite(const uint16_t value);       //  bus access
+//    uint16_t portValue() const;                     //  last read
+//    uint16_t portValueOut() const;                  //  last written
+//
+//  ExpanderPort<T>      CRTP base, adds generic functions, static dispatch.
+//  ExpanderPortV        optional virtual interface for mixed banks.
+//  ExpanderPortAdapter  wraps any port in the virtual interface.
+//
+//  Shared by the related expander libraries, guarded so it is defined once.
+
+
+#ifndef EXPANDER_PORT_VERSION
+#define EXPANDER_PORT_VERSION       (F("0.1.0"))
+
+
+#include "Arduino.h"
+
+
+//  CAPABILITIES
+#define EXPANDER_CAP_QUASI_BIDIR    0x0001    //  no direction register (PCF857x)
+#define EXPANDER_CAP_DIRECTION      0x0002    //  direction register (MCP230xx)
+#define EXPANDER_CAP_PULLUP         0x0004    //  configurable pull ups
+#define EXPANDER_CAP_POLARITY       0x0008    //  input polarity register
+#define EXPANDER_CAP_INTERRUPT      0x0010    //  INT line
+
+
+//////////////////////////////////////////////////////////////
+//
+//  CRTP BASE
+//
+template <class T>
+class ExpanderPort
+{
+public:
+  //  writes only the bits in mask.
+  void     portUpdate(const uint16_t mask, const uint16_t value)
+  {
+    self().portWrite((self().portValueOut() & ~mask) | (value & mask));
+  }
+  void     portSet(const uint16_t mask)    { self().portWrite(self().portValueOut() | mask); };
+  void     portClear(const uint16_t mask)  { self().portWrite(self().portValueOut() & ~mask); };
+  void     portToggle(const uint16_t mask) { self().portWrite(self().portValueOut() ^ mask); };
+  uint16_t portMask() const { return (T::portWidth() == 16) ? 0xFFFF : ((1U << T::portWidth()) - 1); };
+  bool     portHas(const uint16_t capability) const { return (T::portCapabilities() & capability) == capability; };
+
+
+private:
+  T & self()             { return static_cast<T &>(*this); };
+  const T & self() const { return static_cast<const T &>(*this); };
+};
+
+
+//////////////////////////////////////////////////////////////
+//
+//  VIRTUAL INTERFACE
+//
+class ExpanderPortV
+{
+public:
+  virtual ~ExpanderPortV() {};
+
+  virtual uint8_t  portWidth() const = 0;
+  virtual uint16_t portCapabilities() const = 0;
+  virtual uint16_t portRead() = 0;
+  virtual void     portWrite(const uint16_t value) = 0;
+  virtual uint16_t portValue() const = 0;
+  virtual uint16_t portValueOut() const = 0;
+
+  void     portUpdate(const uint16_t mask, const uint16_t value)
+  {
+    portWrite((portValueOut() & ~mask) | (value & mask));
+  }
+};
+
+
+template <class T>
+class ExpanderPortAdapter : public ExpanderPortV
+{
+public:
+  explicit ExpanderPortAdapter(T & port) : _port(port) {};
+
+  uint8_t  portWidth() const          { return T::portWidth(); };
+  uint16_t portCapabilities() const   { return T::portCapabilities(); };
+  uint16_t portRead()                 { return _port.portRead(); };
+  void     portWrite(const uint16_t value) { _port.portWrite(value); };
+  uint16_t portValue() const          { return _port.portValue(); };
+  uint16_t portValueOut() const       { return _port.portValueOut(); };
+
+private:
+  T & _port;
+};
+
+
+#endif
+
+
+//  -- END OF FILE --
+
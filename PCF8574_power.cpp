@@ -0,0 +1,169 @@
+//
+//    FILE: PCF8574_power.cpp
+//  AUTHOR: Rob Tillaart
+//    DATE: 2026-10-18
+// VERSION: 0.5.0
+// PURPOSE: Arduino library for PCF8574 - inrush current budget scheduler
+//     URL: https://github.com/RobTillaart/PCF8574
+
+
+#include "PCF8574_power.h"
+
+
+PCF8574_PowerScheduler::PCF8574_PowerScheduler(PCF8574 * device, const uint16_t budget, const uint32_t frameDelay)
+: _device {device}, _budget {budget}, _frameDelay {frameDelay}
+{
+  for (uint8_t i = 0; i < 8; i++) _current[i] = 0;
+}
+
+
+void PCF8574_PowerScheduler::setCurrent(const uint8_t pin, const uint16_t current)
+{
+  if (pin > 7) return;
+  _current[pin] = current;
+}
+
+
+uint16_t PCF8574_PowerScheduler::getCurrent(const uint8_t pin) const
+{
+  if (pin > 7) return 0;
+  return _current[pin];
+}
+
+
+//  exact search, packs the loads pins[index..n-1] in k frames.
+//  a frame opened by a load over budget takes no other load.
+//  all empty frames are equivalent, so a load only tries the first one.
+static bool PCF8574_pack(const uint16_t * current, const uint8_t * pins, const uint8_t n,
+                         const uint8_t index, const uint8_t k, const uint16_t budget,
+                         uint8_t * mask, uint16_t * load)
+{
+  if (index == n) return true;
+  uint8_t pin = pins[index];
+  for (uint8_t f = 0; f < k; f++)
+  {
+    bool empty = (mask[f] == 0);
+    if (empty || ((uint32_t)load[f] + current[pin] <= budget))
+    {
+      mask[f] |= (1 << pin);
+      load[f] += current[pin];
+      if (PCF8574_pack(current, pins, n, index + 1, k, budget, mask, load)) return true;
+      mask[f] &= ~(1 << pin);
+      load[f] -= current[pin];
+    }
+    if (empty) break;
+  }
+  return false;
+}
+
+
+uint8_t PCF8574_PowerScheduler::plan(const uint8_t value, uint8_t * frames) const
+{
+  //  work in "energized" domain, 1 == load on.
+  uint8_t oldOn = _device->valueOut() ^ _activeLow;
+  uint8_t newOn = value ^ _activeLow;
+  uint8_t rising = newOn & ~oldOn;
+
+  //  rising lines, largest current first.
+  uint8_t  pins[8];
+  uint8_t  n = 0;
+  uint32_t total = 0;
+  uint8_t  todo = rising;
+  while (todo != 0)
+  {
+    uint8_t pin = 0;
+    for (uint8_t i = 0; i < 8; i++)
+    {
+      if ((todo & (1 << i)) && (((todo & (1 << pin)) == 0) || (_current[i] > _current[pin]))) pin = i;
+    }
+    todo &= ~(1 << pin);
+    pins[n++] = pin;
+    total += _current[pin];
+  }
+
+  //  first fit decreasing gives an upper bound,
+  //  the exact search tries fewer frames, 8 lines => at most 8 frames.
+  uint8_t  mask[8];
+  uint16_t load[8];
+  uint8_t  count = 0;
+  for (uint8_t i = 0; i < n; i++)
+  {
+    uint8_t pin = pins[i];
+    uint8_t f = 0;
+    while ((f < count) && ((uint32_t)load[f] + _current[pin] > _budget)) f++;
+    if (f == count)
+    {
+      //  new frame, a single load over budget gets its own frame.
+      mask[count] = 0;
+      load[count] = 0;
+      count++;
+    }
+    mask[f] |= (1 << pin);
+    load[f] += _current[pin];
+  }
+  //  total current / budget is a lower bound.
+  uint8_t k = count;
+  if (_budget > 0)
+  {
+    uint32_t bound = (total + _budget - 1) / _budget;
+    if (bound < count) k = (bound == 0) ? 1 : bound;
+  }
+  for (; k < count; k++)
+  {
+    uint8_t  m[8];
+    uint16_t l[8];
+    for (uint8_t f = 0; f < k; f++)
+    {
+      m[f] = 0;
+      l[f] = 0;
+    }
+    if (PCF8574_pack(_current, pins, n, 0, k, _budget, m, l))
+    {
+      for (uint8_t f = 0; f < k; f++) mask[f] = m[f];
+      count = k;
+      break;
+    }
+  }
+
+  //  frame k: all other lines at their new value, rising lines of frames 0..k.
+  uint8_t on = newOn & ~rising;
+  if (count == 0)
+  {
+    frames[0] = value;
+    return 1;
+  }
+  for (uint8_t f = 0; f < count; f++)
+  {
+    on |= mask[f];
+    frames[f] = on ^ _activeLow;
+  }
+  return count;
+}
+
+
+uint8_t PCF8574_PowerScheduler::write8(const uint8_t value)
+{
+  uint8_t frames[8];
+  uint8_t count = plan(value, frames);
+
+  uint32_t start = PCF8574_micros();
+  if ((_frameDelay == 0) || (count == 1))
+  {
+    _device->writeArray(frames, count);
+  }
+  else
+  {
+    for (uint8_t f = 0; f < count; f++)
+    {
+      if (f > 0) PCF8574_delayMicros(_frameDelay);
+      _device->write8(frames[f]);
+    }
+  }
+  _lastLatency = PCF8574_micros() - start;
+  _lastFrames = count;
+  return count;
+}
+
+
+//  -- END OF FILE --
+
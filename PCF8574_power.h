@@ -0,0 +1,68 @@
+#pragma once
+//
+//    FILE: PCF8574_power.h
+//  AUTHOR: Rob Tillaart
+//    DATE: 2026-10-18
+// VERSION: 0.5.0
+// PURPOSE: Arduino library for PCF8574 - inrush current budget scheduler
+//     URL: https://github.com/RobTillaart/PCF8574
+//
+//  Switching on many relays at once can brown out the supply.
+//  The scheduler splits the lines that switch on into the fewest frames
+//  whose inrush current stays within the budget. First fit decreasing
+//  gives a start, an exact search (8 lines max) then tries fewer frames.
+//  Lines that switch off are switched in the first frame.
+//
+//  The frame delay must cover the inrush time of the loads, a relay coil
+//  needs ~5-20 ms, an incandescent lamp or motor on the contacts longer.
+//  Frames without delay are only ~9 SCL clocks apart (~90 us @100 KHz),
+//  the inrush currents then still add up. So there is no default, the
+//  delay is a constructor argument.
+
+
+#include "PCF8574.h"
+
+
+class PCF8574_PowerScheduler
+{
+public:
+  //  budget in mA (or any unit, as long as setCurrent() uses the same)
+  //  frameDelay in micros between frames, see above.
+  PCF8574_PowerScheduler(PCF8574 * device, const uint16_t budget, const uint32_t frameDelay);
+
+  void     setBudget(const uint16_t budget) { _budget = budget; };
+  uint16_t getBudget() const { return _budget; };
+  //  inrush current of the load on pin.
+  void     setCurrent(const uint8_t pin, const uint16_t current);
+  uint16_t getCurrent(const uint8_t pin) const;
+  //  lines that energize their load when LOW (most relay boards).
+  void     setActiveLow(const uint8_t mask) { _activeLow = mask; };
+  uint8_t  getActiveLow() const { return _activeLow; };
+  //  0 = frames streamed in one transaction, only for loads without inrush.
+  //  otherwise separate writes with delay micros in between.
+  void     setFrameDelay(const uint32_t us) { _frameDelay = us; };
+  uint32_t getFrameDelay() const { return _frameDelay; };
+
+  //  writes value in frames, returns number of frames.
+  uint8_t  write8(const uint8_t value);
+  //  fills frames[8] with the values to write, returns number of frames.
+  uint8_t  plan(const uint8_t value, uint8_t * frames) const;
+
+  uint8_t  lastFrames() const  { return _lastFrames; };
+  //  micros from start of the first frame until end of the last frame.
+  uint32_t lastLatency() const { return _lastLatency; };
+
+
+private:
+  PCF8574 * _device;
+  uint16_t  _budget;
+  uint16_t  _current[8];
+  uint8_t   _activeLow {0x00};
+  uint32_t  _frameDelay;
+  uint8_t   _lastFrames {0};
+  uint32_t  _lastLatency {0};
+};
+
+
+//  -- END OF FILE --
+
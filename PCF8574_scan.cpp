@@ -0,0 +1,89 @@
+//
+//    FILE: PCF8574_scan.cpp
+//  AUTHOR: Rob Tillaart
+//    DATE: 2026-10-18
+// VERSION: 0.5.0
+// PURPOSE: Arduino library for PCF8574 - PLC style scan cycle on a bank
+//     URL: https://github.com/RobTillaart/PCF8574
+
+
+#include "PCF8574_scan.h"
+
+
+PCF8574_ScanCycle::PCF8574_ScanCycle(PCF8574_Bank * bank, PCF8574_ScanLogic logic)
+: _bank {bank}, _logic {logic}
+{
+  memset(_in, 0, sizeof(_in));
+  memset(_out, 0xFF, sizeof(_out));
+}
+
+
+void PCF8574_ScanCycle::begin()
+{
+  for (uint8_t i = 0; i < _bank->size(); i++)
+  {
+    _out[i] = _bank->device(i)->valueOut();
+  }
+  _lastScan = PCF8574_micros();
+}
+
+
+uint8_t PCF8574_ScanCycle::scan()
+{
+  uint32_t start = PCF8574_micros();
+  _lastScan = start;
+
+  //  input image
+  uint8_t failed = _bank->read();
+  uint8_t size = _bank->size();
+  for (uint8_t i = 0; i < size; i++) _in[i] = _bank->value(i);
+  uint32_t bus = PCF8574_micros() - start;
+
+  if (_logic != nullptr) _logic(_in, _out);
+
+  //  output image, commit() only writes the changed devices.
+  uint32_t t = PCF8574_micros();
+  for (uint8_t i = 0; i < size; i++) _bank->stage(i, _out[i]);
+  failed += _bank->commit();
+  uint32_t now = PCF8574_micros();
+  bus += now - t;
+
+  //  statistics
+  uint32_t cycle = now - start;
+  _lastCycle = cycle;
+  _cycles++;
+  if ((_cycles == 1) || (cycle < _minCycle)) _minCycle = cycle;
+  if (cycle > _maxCycle) _maxCycle = cycle;
+  _avgCycle += (cycle - _avgCycle) / _cycles;
+  float share = (cycle > 0) ? (100.0 * bus / cycle) : 0;
+  _busShare += (share - _busShare) / _cycles;
+
+  _lastOverrun = (_watchdog > 0) && (cycle > _watchdog);
+  if (_lastOverrun) _overruns++;
+  return failed;
+}
+
+
+bool PCF8574_ScanCycle::update()
+{
+  if (PCF8574_micros() - _lastScan < _period) return false;
+  scan();
+  return true;
+}
+
+
+void PCF8574_ScanCycle::resetStatistics()
+{
+  _cycles    = 0;
+  _minCycle  = 0;
+  _maxCycle  = 0;
+  _avgCycle  = 0;
+  _lastCycle = 0;
+  _busShare  = 0;
+  _overruns  = 0;
+  _lastOverrun = false;
+}
+
+
+//  -- END OF FILE --
+
@@ -0,0 +1,81 @@
+#pragma once
+//
+//    FILE: PCF8574_scan.h
+//  AUTHOR: Rob Tillaart
+//    DATE: 2026-10-18
+// VERSION: 0.5.0
+// PURPOSE: Arduino library for PCF8574 - PLC style scan cycle on a bank
+//     URL: https://github.com/RobTillaart/PCF8574
+//
+//  One scan = read input image, call logic, write changed outputs.
+//  The logic only works on the process image in RAM, no bus access.
+
+
+#include "PCF8574_bank.h"
+
+
+//  inputs and outputs hold bank.size() bytes, outputs keep their value between scans.
+typedef void (*PCF8574_ScanLogic)(const uint8_t * inputs, uint8_t * outputs);
+
+
+class PCF8574_ScanCycle
+{
+public:
+  PCF8574_ScanCycle(PCF8574_Bank * bank, PCF8574_ScanLogic logic);
+
+  //  loads the output image from valueOut() of the devices.
+  void     begin();
+  //  one scan, returns number of devices that failed.
+  uint8_t  scan();
+  //  scans if period micros passed since the last scan, returns true if scanned.
+  bool     update();
+  void     setPeriod(const uint32_t period) { _period = period; };
+  uint32_t getPeriod() const { return _period; };
+
+  //  PROCESS IMAGE
+  const uint8_t * inputs() const { return _in; };
+  uint8_t * outputs() { return _out; };
+
+  //  STATISTICS, micros
+  uint32_t cycles() const     { return _cycles; };
+  uint32_t minCycle() const   { return _minCycle; };
+  uint32_t maxCycle() const   { return _maxCycle; };
+  float    avgCycle() const   { return _avgCycle; };
+  uint32_t lastCycle() const  { return _lastCycle; };
+  //  average percentage of the cycle time spent on the bus.
+  float    busShare() const   { return _busShare; };
+  void     resetStatistics();
+
+  //  WATCHDOG
+  //  a scan longer than limit micros is an overrun, 0 == disabled (default).
+  void     setWatchdog(const uint32_t limit) { _watchdog = limit; };
+  uint32_t getWatchdog() const { return _watchdog; };
+  uint32_t overruns() const    { return _overruns; };
+  bool     lastOverrun() const { return _lastOverrun; };
+
+
+private:
+  PCF8574_Bank *    _bank;
+  PCF8574_ScanLogic _logic;
+
+  uint8_t   _in[PCF8574_BANK_SIZE];
+  uint8_t   _out[PCF8574_BANK_SIZE];
+
+  uint32_t  _period {0};
+  uint32_t  _lastScan {0};
+
+  uint32_t  _cycles {0};
+  uint32_t  _minCycle {0};
+  uint32_t  _maxCycle {0};
+  float     _avgCycle {0};
+  uint32_t  _lastCycle {0};
+  float     _busShare {0};
+
+  uint32_t  _watchdog {0};
+  uint32_t  _overruns {0};
+  bool      _lastOverrun {false};
+};
+
+
+//  -- END OF FILE --
+
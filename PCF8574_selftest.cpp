@@ -0,0 +1,123 @@
+//
+//    FILE: PCF8574_selftest.cpp
+//  AUTHOR: Rob Tillaart
+//    DATE: 2026-10-18
+// VERSION: 0.5.0
+// PURPOSE: Arduino library for PCF8574 - output self test, stuck and bridged pins
+//     URL: https://github.com/RobTillaart/PCF8574
+
+
+#include "PCF8574_selftest.h"
+
+
+PCF8574_SelfTest::PCF8574_SelfTest()
+{
+}
+
+
+bool PCF8574_SelfTest::run(PCF8574 * device, PCF8574_FaultMap & map)
+{
+  return _run(&device, 1, &map) == 0;
+}
+
+
+uint16_t PCF8574_SelfTest::run(PCF8574_Bank & bank, PCF8574_FaultMap * maps)
+{
+  PCF8574 * devices[PCF8574_BANK_SIZE];
+  uint8_t count = bank.size();
+  for (uint8_t i = 0; i < count; i++) devices[i] = bank.device(i);
+  uint16_t faults = _run(devices, count, maps);
+  bank.publish();
+  return faults;
+}
+
+
+/////////////////////////////////////////////////////////////
+//
+//  PRIVATE
+//
+//  A HIGH output is only a weak pull up (quasi bidirectional),
+//  a LOW output wins from it. So:
+//  - all HIGH  => pins reading LOW are stuck low.
+//  - all LOW   => pins reading HIGH are stuck high.
+//  - walking zero, pin i LOW => other pins reading LOW are bridged to i.
+//  Walking one adds no information as a bridged HIGH pin always reads LOW,
+//  so it is skipped. Steps = 2 + pins in mask.
+//
+//  Every step writes all devices first, then one settle time, then
+//  reads all devices back, so a bank shares the settle time.
+uint16_t PCF8574_SelfTest::_run(PCF8574 ** devices, const uint8_t count, PCF8574_FaultMap * maps)
+{
+  uint32_t start = PCF8574_micros();
+  uint8_t  saved[PCF8574_BANK_SIZE];
+  for (uint8_t d = 0; d < count; d++)
+  {
+    saved[d] = devices[d]->valueOut();
+    devices[d]->lastError();  //  reset error
+    maps[d].stuckLow  = 0;
+    maps[d].stuckHigh = 0;
+    for (uint8_t p = 0; p < 8; p++) maps[d].bridged[p] = 0;
+    maps[d].error = PCF8574_OK;
+  }
+
+  //  step 0 = all HIGH, step 1 = all LOW, step 2.. = walking zero.
+  _steps = 0;
+  for (uint8_t step = 0; step < 10; step++)
+  {
+    uint8_t pin = step - 2;
+    if ((step >= 2) && ((_mask & (1 << pin)) == 0)) continue;
+    uint8_t pattern = 0xFF;
+    if (step == 1) pattern = ~_mask;
+    if (step >= 2) pattern = ~(1 << pin);
+    _steps++;
+
+    for (uint8_t d = 0; d < count; d++)
+    {
+      if (maps[d].error != PCF8574_OK) continue;
+      devices[d]->write8(pattern);
+      maps[d].error = devices[d]->lastError();
+    }
+    if (_settle > 0) PCF8574_delayMicros(_settle);
+    for (uint8_t d = 0; d < count; d++)
+    {
+      PCF8574_FaultMap & map = maps[d];
+      if (map.error != PCF8574_OK) continue;
+      uint8_t value = devices[d]->read8();
+      map.error = devices[d]->lastError();
+      if (map.error != PCF8574_OK) continue;
+
+      if (step == 0) map.stuckLow  = ~value & _mask;
+      if (step == 1) map.stuckHigh =  value & _mask;
+      if (step >= 2)
+      {
+        uint8_t low = ~value & _mask & ~(1 << pin) & ~map.stuckLow;
+        //  a stuck high pin cannot pull its neighbours LOW.
+        if (map.stuckHigh & (1 << pin)) low = 0;
+        map.bridged[pin] |= low;
+        for (uint8_t p = 0; p < 8; p++)
+        {
+          if (low & (1 << p)) map.bridged[p] |= (1 << pin);
+        }
+      }
+    }
+  }
+
+  uint16_t faults = 0;
+  for (uint8_t d = 0; d < count; d++)
+  {
+    devices[d]->write8(saved[d]);
+    PCF8574_FaultMap & map = maps[d];
+    uint8_t bridged = 0;
+    for (uint8_t p = 0; p < 8; p++) bridged |= map.bridged[p];
+    if ((map.error != PCF8574_OK) || map.stuckLow || map.stuckHigh || bridged)
+    {
+      faults |= (1U << d);
+    }
+  }
+  _duration = PCF8574_micros() - start;
+  return faults;
+}
+
+
+//  -- END OF FILE --
+
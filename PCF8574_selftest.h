@@ -0,0 +1,61 @@
+#pragma once
+//
+//    FILE: PCF8574_selftest.h
+//  AUTHOR: Rob Tillaart
+//    DATE: 2026-10-18
+// VERSION: 0.5.0
+// PURPOSE: Arduino library for PCF8574 - output self test, stuck and bridged pins
+//     URL: https://github.com/RobTillaart/PCF8574
+//
+//  WARNING: the self test switches the outputs, disconnect loads
+//  that may not be switched (motors, heaters) or exclude them with setMask().
+
+
+#include "PCF8574_bank.h"
+
+
+struct PCF8574_FaultMap
+{
+  uint8_t stuckLow;       //  pins that read LOW when written HIGH
+  uint8_t stuckHigh;      //  pins that read HIGH when written LOW
+  uint8_t bridged[8];     //  per pin, the pins it is shorted with
+  uint8_t error;          //  PCF8574_OK or the I2C error that aborted the test
+};
+
+
+class PCF8574_SelfTest
+{
+public:
+  PCF8574_SelfTest();
+
+  //  pins to test, other pins stay HIGH (input) during the test.
+  void     setMask(const uint8_t mask) { _mask = mask; };
+  uint8_t  getMask() const { return _mask; };
+  //  micros between writing a pattern and reading it back.
+  void     setSettle(const uint32_t us) { _settle = us; };
+  uint32_t getSettle() const { return _settle; };
+
+  //  returns true if no fault found. Restores the outputs afterwards.
+  bool     run(PCF8574 * device, PCF8574_FaultMap & map);
+  //  maps must hold bank.size() entries.
+  //  returns mask of devices with a fault.
+  uint16_t run(PCF8574_Bank & bank, PCF8574_FaultMap * maps);
+
+  //  patterns of the last run, each is a write and a read per device.
+  uint8_t  steps() const { return _steps; };
+  //  micros of the last run.
+  uint32_t duration() const { return _duration; };
+
+
+private:
+  uint8_t  _mask {0xFF};
+  uint32_t _settle {0};
+  uint8_t  _steps {0};
+  uint32_t _duration {0};
+
+  uint16_t _run(PCF8574 ** devices, const uint8_t count, PCF8574_FaultMap * maps);
+};
+
+
+//  -- END OF FILE --
+
@@ -0,0 +1,183 @@
+//
+//    FILE: PCF8574_sim.cpp
+//  AUTHOR: Rob Tillaart
+//    DATE: 2026-10-18
+// VERSION: 0.5.0
+// PURPOSE: Arduino library for PCF8574 - simulated bus with fault injection
+//     URL: https://github.com/RobTillaart/PCF8574
+
+
+#include "PCF8574_sim.h"
+#include "PCF8574_clock.h"
+
+
+PCF8574_Sim::PCF8574_Sim()
+{
+}
+
+
+/////////////////////////////////////////////////////////////
+//
+//  SIMULATED DEVICES
+//
+bool PCF8574_Sim::addDevice(const uint8_t address)
+{
+  if ((_size >= PCF8574_SIM_DEVICES) || (_find(address) != nullptr)) return false;
+  Device & d = _devices[_size++];
+  d.address = address;
+  d.latch   = 0xFF;     //  power on reset
+  d.input   = 0xFF;     //  nothing connected
+  d.intRef  = 0xFF;
+  d.count   = 0;
+  d.last    = 0;
+  return true;
+}
+
+
+void PCF8574_Sim::setInput(const uint8_t address, const uint8_t levels)
+{
+  Device * d = _find(address);
+  if (d != nullptr) d->input = levels;
+}
+
+
+uint8_t PCF8574_Sim::getInput(const uint8_t address)
+{
+  Device * d = _find(address);
+  return (d == nullptr) ? 0xFF : d->input;
+}
+
+
+uint8_t PCF8574_Sim::getLatch(const uint8_t address)
+{
+  Device * d = _find(address);
+  return (d == nullptr) ? 0xFF : d->latch;
+}
+
+
+uint8_t PCF8574_Sim::getLevels(const uint8_t address)
+{
+  Device * d = _find(address);
+  return (d == nullptr) ? 0xFF : (d->latch & d->input);
+}
+
+
+bool PCF8574_Sim::interrupt(const uint8_t address)
+{
+  Device * d = _find(address);
+  return (d != nullptr) && ((d->latch & d->input) != d->intRef);
+}
+
+
+uint32_t PCF8574_Sim::transactions(const uint8_t address)
+{
+  Device * d = _find(address);
+  return (d == nullptr) ? 0 : d->count;
+}
+
+
+uint32_t PCF8574_Sim::lastTransaction(const uint8_t address)
+{
+  Device * d = _find(address);
+  return (d == nullptr) ? 0 : d->last;
+}
+
+
+/////////////////////////////////////////////////////////////
+//
+//  FAULT INJECTION
+//
+bool PCF8574_Sim::addRule(const PCF8574_FaultRule & rule)
+{
+  if (_rules >= PCF8574_SIM_RULES) return false;
+  _rule[_rules++] = rule;
+  return true;
+}
+
+
+/////////////////////////////////////////////////////////////
+//
+//  TRANSPORT
+//
+uint8_t PCF8574_Sim::write(const uint8_t address, const uint8_t * data, const uint8_t count)
+{
+  Device * d = _find(address);
+  if (d == nullptr) return 2;
+  uint8_t low = 0, high = 0;
+  uint8_t f = _faults(d, PCF8574_FAULT_ON_WRITE, d->latch, low, high);
+  if (f & (1 << PCF8574_FAULT_NACK)) return 2;
+  //  every byte is latched at its ACK, last one remains.
+  for (uint8_t i = 0; i < count; i++)
+  {
+    d->latch = data[i];
+  }
+  d->intRef = d->latch & d->input;
+  return 0;
+}
+
+
+uint8_t PCF8574_Sim::read(const uint8_t address, uint8_t & value)
+{
+  Device * d = _find(address);
+  if (d == nullptr) return 0;
+  uint8_t low = 0, high = 0;
+  uint8_t levels = d->latch & d->input;
+  uint8_t f = _faults(d, PCF8574_FAULT_ON_READ, levels, low, high);
+  if (f & ((1 << PCF8574_FAULT_NACK) | (1 << PCF8574_FAULT_SHORT_READ))) return 0;
+  d->intRef = levels;
+  value = (levels & ~low) | high;
+  return 1;
+}
+
+
+/////////////////////////////////////////////////////////////
+//
+//  PROTECTED
+//
+PCF8574_Sim::Device * PCF8574_Sim::_find(const uint8_t address)
+{
+  for (uint8_t i = 0; i < _size; i++)
+  {
+    if (_devices[i].address == address) return &_devices[i];
+  }
+  return nullptr;
+}
+
+
+//  xorshift32, deterministic for a given seed.
+uint32_t PCF8574_Sim::_random()
+{
+  _seed ^= _seed << 13;
+  _seed ^= _seed >> 17;
+  _seed ^= _seed << 5;
+  return _seed;
+}
+
+
+uint8_t PCF8574_Sim::_faults(Device * dev, const uint8_t on, const uint8_t levels, uint8_t & lowMask, uint8_t & highMask)
+{
+  uint32_t n = dev->count++;
+  dev->last = ++_total;
+  uint8_t  hit = 0;
+  for (uint8_t i = 0; i < _rules; i++)
+  {
+    const PCF8574_FaultRule & r = _rule[i];
+    if ((r.address != PCF8574_SIM_ALL) && (r.address != dev->address)) continue;
+    if ((r.on & on) == 0) continue;
+    if ((n < r.from) || (n > r.to)) continue;
+    if ((r.probability < 100) && ((_random() % 100) >= r.probability)) continue;
+
+    _injected++;
+    hit |= (1 << r.type);
+    if (r.type == PCF8574_FAULT_STUCK_LOW)  lowMask  |= r.mask;
+    if (r.type == PCF8574_FAULT_STUCK_HIGH) highMask |= r.mask;
+    //  wired AND, one LOW line pulls the others LOW.
+    if ((r.type == PCF8574_FAULT_BRIDGE) && ((levels & r.mask) != r.mask)) lowMask |= r.mask;
+    if (r.type == PCF8574_FAULT_STRETCH)    PCF8574_delayMicros(r.delay);
+  }
+  return hit;
+}
+
+
+//  -- END OF FILE --
+
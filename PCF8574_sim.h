@@ -0,0 +1,127 @@
+#pragma once
+//
+//    FILE: PCF8574_sim.h
+//  AUTHOR: Rob Tillaart
+//    DATE: 2026-10-18
+// VERSION: 0.5.0
+// PURPOSE: Arduino library for PCF8574 - simulated bus with fault injection
+//     URL: https://github.com/RobTillaart/PCF8574
+//
+//  A PCF8574 attached to a simulator with setSim() does not use Wire,
+//  so error paths can be tested deterministically without hardware.
+//  setSim() needs PCF8574_SIM defined for the whole build, see PCF8574.h.
+
+
+#include "Arduino.h"
+
+
+#ifndef PCF8574_SIM_DEVICES
+#define PCF8574_SIM_DEVICES         8
+#endif
+
+#ifndef PCF8574_SIM_RULES
+#define PCF8574_SIM_RULES           8
+#endif
+
+
+//  FAULT TYPES
+#define PCF8574_FAULT_NACK          0x01    //  no ACK, write not latched, read fails
+#define PCF8574_FAULT_SHORT_READ    0x02    //  requestFrom() returns 0 bytes
+#define PCF8574_FAULT_STUCK_LOW     0x03    //  mask lines read LOW
+#define PCF8574_FAULT_STUCK_HIGH    0x04    //  mask lines read HIGH
+#define PCF8574_FAULT_STRETCH       0x05    //  clock stretching, delay micros
+#define PCF8574_FAULT_BRIDGE        0x06    //  mask lines shorted, one LOW pulls all LOW
+
+//  TRANSACTIONS
+#define PCF8574_FAULT_ON_READ       0x01
+#define PCF8574_FAULT_ON_WRITE      0x02
+#define PCF8574_FAULT_ON_ALL        0x03
+
+#define PCF8574_SIM_ALL             0xFF    //  rule for all addresses
+#define PCF8574_SIM_FOREVER         0xFFFFFFFF
+
+
+//  A rule applies to transaction numbers from..to (inclusive, per device)
+//  with a probability in percent.
+//  e.g. device disappears after 100 transactions:
+//    { 0x20, PCF8574_FAULT_NACK, PCF8574_FAULT_ON_ALL, 100, 0, 0, 100, PCF8574_SIM_FOREVER }
+struct PCF8574_FaultRule
+{
+  uint8_t  address;       //  PCF8574_SIM_ALL == all
+  uint8_t  type;          //  PCF8574_FAULT_xxx
+  uint8_t  on;            //  PCF8574_FAULT_ON_xxx
+  uint8_t  probability;   //  0..100 %
+  uint8_t  mask;          //  stuck lines
+  uint16_t delay;         //  stretch micros
+  uint32_t from;
+  uint32_t to;
+};
+
+
+class PCF8574_Sim
+{
+public:
+  PCF8574_Sim();
+
+  //  SIMULATED DEVICES
+  //  returns false if full or address exists.
+  bool     addDevice(const uint8_t address);
+  //  external levels on the lines, a 0 pulls the line LOW.
+  void     setInput(const uint8_t address, const uint8_t levels);
+  uint8_t  getInput(const uint8_t address);
+  //  last value written (the output latch).
+  uint8_t  getLatch(const uint8_t address);
+  //  line levels: latch AND external levels (quasi bidirectional).
+  uint8_t  getLevels(const uint8_t address);
+  //  true == INT active (LOW), levels changed since last read / write.
+  bool     interrupt(const uint8_t address);
+  uint32_t transactions(const uint8_t address);
+  //  bus wide number of the last transaction of the device, 0 == none.
+  //  compare two devices to check the order of transactions.
+  uint32_t lastTransaction(const uint8_t address);
+
+
+  //  FAULT INJECTION
+  bool     addRule(const PCF8574_FaultRule & rule);
+  void     clearRules() { _rules = 0; };
+  //  seed of the pseudo random generator => reproducible runs.
+  void     setSeed(const uint32_t seed) { _seed = (seed == 0) ? 1 : seed; };
+  //  number of faults injected.
+  uint32_t injected() const { return _injected; };
+
+
+  //  TRANSPORT used by PCF8574
+  //  returns Wire error code, 0 == OK, 2 == address NACK.
+  uint8_t  write(const uint8_t address, const uint8_t * data, const uint8_t count);
+  //  returns number of bytes read, 0 or 1.
+  uint8_t  read(const uint8_t address, uint8_t & value);
+
+
+protected:
+  struct Device
+  {
+    uint8_t  address;
+    uint8_t  latch;
+    uint8_t  input;
+    uint8_t  intRef;       //  levels at last read / write
+    uint32_t count;
+    uint32_t last;
+  };
+  Device   _devices[PCF8574_SIM_DEVICES];
+  uint8_t  _size {0};
+
+  PCF8574_FaultRule _rule[PCF8574_SIM_RULES];
+  uint8_t  _rules {0};
+  uint32_t _seed {1};
+  uint32_t _injected {0};
+  uint32_t _total {0};
+
+  Device * _find(const uint8_t address);
+  uint32_t _random();
+  //  returns mask of fault types (1 << type) that hit this transaction.
+  uint8_t  _faults(Device * dev, const uint8_t on, const uint8_t levels, uint8_t & lowMask, uint8_t & highMask);
+};
+
+
+//  -- END OF FILE --
+
@@ -0,0 +1,41 @@
+#pragma once
+//
+//    FILE: PCF8574_trace.h
+//  AUTHOR: Rob Tillaart
+//    DATE: 2026-10-18
+// VERSION: 0.5.0
+// PURPOSE: Arduino library for PCF8574 - static tracepoints (USDT)
+//     URL: https://github.com/RobTillaart/PCF8574
+//
+//  Define PCF8574_USDT for the whole build (Linux host builds only) to
+//  add USDT probes (sys/sdt.h) usable by perf, bpftrace, LTTng, systemtap.
+//  Probes are NOP instructions until a tracer attaches.
+//  When not defined the macros expand to nothing => zero cost.
+//
+//  provider: pcf8574
+//  probe          arguments
+//  read_start     address
+//  read_end       address, value
+//  write_start    address, value
+//  write_end      address, error
+//  error          address, error
+//
+//  e.g.  bpftrace -e 'usdt:./app:pcf8574:write_end { @[arg0] = count(); }'
+
+
+#if defined(PCF8574_USDT)
+
+#include <sys/sdt.h>
+#define PCF8574_TRACE1(name, a)          DTRACE_PROBE1(pcf8574, name, a)
+#define PCF8574_TRACE2(name, a, b)       DTRACE_PROBE2(pcf8574, name, a, b)
+
+#else
+
+#define PCF8574_TRACE1(name, a)          do {} while (0)
+#define PCF8574_TRACE2(name, a, b)       do {} while (0)
+
+#endif
+
+
+//  -- END OF FILE --
+
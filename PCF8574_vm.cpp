@@ -0,0 +1,178 @@
+//
+//    FILE: PCF8574_vm.cpp
+//  AUTHOR: Rob Tillaart
+//    DATE: 2026-10-18
+// VERSION: 0.5.0
+// PURPOSE: Arduino library for PCF8574 - bytecode interpreter for sequences on a bank
+//     URL: https://github.com/RobTillaart/PCF8574
+
+
+#include "PCF8574_vm.h"
+
+
+//  instruction length including operands, index = instruction.
+static const uint8_t PCF8574_VM_LENGTH[] = { 1, 3, 4, 6, 3, 3, 2, 1, 2, 5 };
+
+
+//  16 bit little endian operand.
+//  unsigned math, int is 16 bit on AVR so (p[1] << 8) can be negative.
+static inline uint16_t PCF8574_VM_word(const uint8_t * p)
+{
+  return p[0] | ((unsigned int)p[1] << 8);
+}
+
+
+PCF8574_VM::PCF8574_VM(PCF8574_Bank * bank)
+: _bank {bank}
+{
+  setResultBuffer(nullptr, 0);
+}
+
+
+void PCF8574_VM::setResultBuffer(uint8_t * buffer, const uint8_t size)
+{
+  _results = buffer;
+  _size = size;
+  if (buffer == nullptr)
+  {
+    _results = _buffer;
+    _size = PCF8574_VM_RESULTS;
+  }
+}
+
+
+uint8_t PCF8574_VM::run(const uint8_t * program, const uint16_t length)
+{
+  uint16_t loopStart[PCF8574_VM_DEPTH];
+  uint8_t  loopCount[PCF8574_VM_DEPTH];
+  uint8_t  depth = 0;
+  uint8_t  status = PCF8574_VM_OK;
+  uint16_t pc = 0;
+
+  _count = 0;
+  _transactions = 0;
+  _errorAddress = 0;
+
+  while ((pc < length) && (status == PCF8574_VM_OK))
+  {
+    const uint8_t * ins = &program[pc];
+    uint8_t op = ins[0];
+    if ((op >= sizeof(PCF8574_VM_LENGTH)) || (pc + PCF8574_VM_LENGTH[op] > length))
+    {
+      status = PCF8574_VM_BAD_CODE;
+      break;
+    }
+    uint16_t next = pc + PCF8574_VM_LENGTH[op];
+    //  most instructions address a device.
+    PCF8574 * dev = nullptr;
+    if ((op == PCF8574_VM_WRITE) || (op == PCF8574_VM_MASK) || (op == PCF8574_VM_WAIT)
+       || (op == PCF8574_VM_READ) || (op == PCF8574_VM_PULSE))
+    {
+      dev = _bank->device(ins[1]);
+      if (dev == nullptr)
+      {
+        status = PCF8574_VM_BAD_CODE;
+        break;
+      }
+    }
+
+    switch (op)
+    {
+      case PCF8574_VM_END:
+        next = length;
+        break;
+      case PCF8574_VM_WRITE:
+        if (! _write(dev, ins[2])) status = PCF8574_VM_IO_ERROR;
+        break;
+      case PCF8574_VM_MASK:
+        if (! _write(dev, (dev->valueOut() & ~ins[2]) | (ins[3] & ins[2]))) status = PCF8574_VM_IO_ERROR;
+        break;
+      case PCF8574_VM_WAIT:
+      {
+        uint16_t timeout = PCF8574_VM_word(&ins[4]);
+        uint32_t start = PCF8574_millis();
+        while (true)
+        {
+          uint8_t value = dev->read8();
+          _transactions++;
+          PCF8574_elapse(PCF8574_VM_POLL_US);
+          if (dev->lastError() != PCF8574_OK)
+          {
+            status = PCF8574_VM_IO_ERROR;
+            break;
+          }
+          if ((value & ins[2]) == (ins[3] & ins[2])) break;
+          if (PCF8574_millis() - start >= timeout)
+          {
+            status = PCF8574_VM_TIMEOUT;
+            break;
+          }
+        }
+        break;
+      }
+      case PCF8574_VM_DELAY:
+        PCF8574_delayMicros(PCF8574_VM_word(&ins[1]));
+        break;
+      case PCF8574_VM_DELAY_MS:
+        PCF8574_delayMicros(PCF8574_VM_word(&ins[1]) * 1000UL);
+        break;
+      case PCF8574_VM_LOOP:
+        if (depth >= PCF8574_VM_DEPTH) status = PCF8574_VM_FULL;
+        else if (ins[1] == 0) status = PCF8574_VM_BAD_CODE;
+        else
+        {
+          loopStart[depth] = next;
+          loopCount[depth] = ins[1];
+          depth++;
+        }
+        break;
+      case PCF8574_VM_NEXT:
+        if (depth == 0) status = PCF8574_VM_BAD_CODE;
+        else if (--loopCount[depth - 1] > 0) next = loopStart[depth - 1];
+        else depth--;
+        break;
+      case PCF8574_VM_READ:
+        if (_count >= _size)
+        {
+          status = PCF8574_VM_FULL;
+          break;
+        }
+        _results[_count++] = dev->read8();
+        _transactions++;
+        if (dev->lastError() != PCF8574_OK) status = PCF8574_VM_IO_ERROR;
+        break;
+      case PCF8574_VM_PULSE:
+      {
+        uint8_t value = dev->valueOut();
+        if (! _write(dev, value ^ ins[2])) status = PCF8574_VM_IO_ERROR;
+        else
+        {
+          PCF8574_delayMicros(PCF8574_VM_word(&ins[3]));
+          if (! _write(dev, value)) status = PCF8574_VM_IO_ERROR;
+        }
+        break;
+      }
+    }
+    if (status != PCF8574_VM_OK) break;
+    pc = next;
+  }
+  if (status != PCF8574_VM_OK) _errorAddress = pc;
+  if (_transactions > 0) _bank->publish();
+  return status;
+}
+
+
+/////////////////////////////////////////////////////////////
+//
+//  PRIVATE
+//
+bool PCF8574_VM::_write(PCF8574 * dev, const uint8_t value)
+{
+  dev->write8(value);
+  _transactions++;
+  return dev->lastError() == PCF8574_OK;
+}
+
+
+//  -- END OF FILE --
+
@@ -0,0 +1,85 @@
+#pragma once
+//
+//    FILE: PCF8574_vm.h
+//  AUTHOR: Rob Tillaart
+//    DATE: 2026-10-18
+// VERSION: 0.5.0
+// PURPOSE: Arduino library for PCF8574 - bytecode interpreter for sequences on a bank
+//     URL: https://github.com/RobTillaart/PCF8574
+//
+//  A sequence like "set outputs, wait for input, pulse, read" runs
+//  locally at bus speed, the reads are collected in a result buffer.
+//  16 bit operands are little endian.
+
+
+#include "PCF8574_bank.h"
+
+
+#ifndef PCF8574_VM_RESULTS
+#define PCF8574_VM_RESULTS          16
+#endif
+
+#ifndef PCF8574_VM_DEPTH
+#define PCF8574_VM_DEPTH            4       //  nested loops
+#endif
+
+//  time of one WAIT poll under a virtual clock, ~read8() @100 KHz.
+#ifndef PCF8574_VM_POLL_US
+#define PCF8574_VM_POLL_US          132
+#endif
+
+
+//  INSTRUCTIONS                                OPERANDS
+#define PCF8574_VM_END              0x00    //  -
+#define PCF8574_VM_WRITE            0x01    //  dev value
+#define PCF8574_VM_MASK             0x02    //  dev mask value
+#define PCF8574_VM_WAIT             0x03    //  dev mask value timeout(ms, 16 bit)
+#define PCF8574_VM_DELAY            0x04    //  micros (16 bit)
+#define PCF8574_VM_DELAY_MS         0x05    //  millis (16 bit)
+#define PCF8574_VM_LOOP             0x06    //  count, repeats the code until NEXT
+#define PCF8574_VM_NEXT             0x07    //  -
+#define PCF8574_VM_READ             0x08    //  dev, value into next result
+#define PCF8574_VM_PULSE            0x09    //  dev mask micros(16 bit), toggle, delay, toggle back
+
+//  STATUS
+#define PCF8574_VM_OK               0x00
+#define PCF8574_VM_BAD_CODE         0x01    //  unknown instruction, bad device, bad loop
+#define PCF8574_VM_IO_ERROR         0x02
+#define PCF8574_VM_TIMEOUT          0x03    //  WAIT timed out
+#define PCF8574_VM_FULL             0x04    //  result buffer or loop stack full
+
+
+class PCF8574_VM
+{
+public:
+  explicit PCF8574_VM(PCF8574_Bank * bank);
+
+  //  runs until END or the end of the program, returns status.
+  uint8_t  run(const uint8_t * program, const uint16_t length);
+
+  //  results go to an external buffer, nullptr == internal buffer (default).
+  void     setResultBuffer(uint8_t * buffer, const uint8_t size);
+  const uint8_t * results() const { return _results; };
+  uint8_t  resultCount() const  { return _count; };
+
+  //  address of the instruction that failed.
+  uint16_t errorAddress() const { return _errorAddress; };
+  //  I2C transactions of the last run.
+  uint16_t transactions() const { return _transactions; };
+
+
+private:
+  PCF8574_Bank * _bank;
+  uint8_t   _buffer[PCF8574_VM_RESULTS];
+  uint8_t * _results;
+  uint8_t   _size;
+  uint8_t   _count {0};
+  uint16_t  _errorAddress {0};
+  uint16_t  _transactions {0};
+
+  bool      _write(PCF8574 * dev, const uint8_t value);
+};
+
+
+//  -- END OF FILE --
+
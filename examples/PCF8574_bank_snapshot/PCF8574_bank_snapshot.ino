@@ -0,0 +1,78 @@
+//
+//    FILE: PCF8574_bank_snapshot.ino
+//  AUTHOR: Rob Tillaart
+//    DATE: 2026-10-18
+// PURPOSE: demo consistent snapshot of a bank of devices
+//     URL: https://github.com/RobTillaart/PCF8574
+//
+//  loop() owns the bus and publishes, the INT routine only uses the snapshot.
+//  On ESP32 / RP2040 the snapshot can also be read from the other core.
+
+
+#include "PCF8574_bank.h"
+
+PCF8574 PCF1(0x20);
+PCF8574 PCF2(0x21);
+PCF8574 PCF3(0x22);
+
+PCF8574_Bank bank;
+
+const int IRQPIN = 2;
+volatile uint8_t irqIn[3];
+volatile bool    irqValid = false;
+
+
+void pcf_irq()
+{
+  //  no I2C in an interrupt routine, only the last published state.
+  uint8_t in[3];
+  irqValid = bank.snapshot(in, nullptr);
+  for (int i = 0; i < 3; i++) irqIn[i] = in[i];
+}
+
+
+void setup()
+{
+  Serial.begin(115200);
+  Serial.println(__FILE__);
+  Serial.print("PCF8574_LIB_VERSION:\t");
+  Serial.println(PCF8574_LIB_VERSION);
+
+  Wire.begin();
+
+  bank.add(&PCF1);
+  bank.add(&PCF2);
+  bank.add(&PCF3);
+  if (bank.begin() == false)
+  {
+    Serial.println("not all devices connected.");
+  }
+
+  pinMode(IRQPIN, INPUT_PULLUP);
+  attachInterrupt(digitalPinToInterrupt(IRQPIN), pcf_irq, FALLING);
+}
+
+
+void loop()
+{
+  bank.read();   //  read8() all and publish()
+
+  uint8_t in[3], out[3];
+  if (bank.snapshot(in, out))
+  {
+    Serial.print(bank.sequence());
+    for (int i = 0; i < 3; i++)
+    {
+      Serial.print('\t');
+      Serial.print(in[i], HEX);
+      Serial.print('/');
+      Serial.print(out[i], HEX);
+    }
+    Serial.println();
+  }
+  delay(100);
+}
+
+
+//  -- END OF FILE --
+
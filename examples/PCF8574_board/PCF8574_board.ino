@@ -0,0 +1,79 @@
+//
+//    FILE: PCF8574_board.ino
+//  AUTHOR: Rob Tillaart
+//    DATE: 2026-10-18
+// PURPOSE: demo compile time board description
+//     URL: https://github.com/RobTillaart/PCF8574
+//
+//  two PCF8574's, one with relays (active LOW) and one with buttons + LEDs
+
+
+#include "PCF8574_board.h"
+
+
+//  device table, constant initialized, no constructor code at startup.
+PCF8574 devices[] = { PCF8574(0x20), PCF8574(0x21) };
+
+//  pin table, index in this table is the "board pin".
+enum { RELAY_PUMP, RELAY_FAN, BUTTON_START, BUTTON_STOP, LED_RUN, PIN_COUNT };
+
+constexpr PCF8574_PinDef pins[PIN_COUNT] =
+{
+  { 0, 0, PCF8574_PIN_OUTPUT | PCF8574_PIN_INVERTED },  //  RELAY_PUMP
+  { 0, 1, PCF8574_PIN_OUTPUT | PCF8574_PIN_INVERTED },  //  RELAY_FAN
+  { 1, 0, PCF8574_PIN_INPUT  | PCF8574_PIN_INVERTED },  //  BUTTON_START  (to GND)
+  { 1, 1, PCF8574_PIN_INPUT  | PCF8574_PIN_INVERTED },  //  BUTTON_STOP   (to GND)
+  { 1, 7, PCF8574_PIN_OUTPUT },                         //  LED_RUN
+};
+
+//  checked by the compiler, no runtime cost.
+//  PCF8574_BoardOf also checks PCF8574_boardValid().
+static_assert(PCF8574_buttonMask(pins, PIN_COUNT, 1) == 0x03, "unexpected button mask");
+
+//  button masks and initial values are computed at compile time.
+PCF8574_BoardOf<pins, PIN_COUNT, 2> board(devices);
+
+
+void setup()
+{
+  Serial.begin(115200);
+  Serial.println(__FILE__);
+  Serial.print("PCF8574_LIB_VERSION:\t");
+  Serial.println(PCF8574_LIB_VERSION);
+
+  Wire.begin();
+
+  if (board.begin() == false)
+  {
+    Serial.print("device not connected:\t");
+    Serial.println(board.lastErrorDevice());
+  }
+  //  compile time table used by begin()
+  typedef PCF8574_BoardMasks<pins, PIN_COUNT, 2> Masks;
+  Serial.print("initial device 0:\t");
+  Serial.println(Masks::masks[0].initialValue, BIN);
+  Serial.print("initial device 1:\t");
+  Serial.println(Masks::masks[1].initialValue, BIN);
+}
+
+
+void loop()
+{
+  if (board.read(BUTTON_START))
+  {
+    board.write(RELAY_PUMP, HIGH);
+    board.write(RELAY_FAN, HIGH);
+    board.write(LED_RUN, HIGH);
+  }
+  if (board.read(BUTTON_STOP))
+  {
+    board.write(RELAY_PUMP, LOW);
+    board.write(RELAY_FAN, LOW);
+    board.write(LED_RUN, LOW);
+  }
+  delay(20);
+}
+
+
+//  -- END OF FILE --
+
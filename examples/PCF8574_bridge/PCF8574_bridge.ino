@@ -0,0 +1,44 @@
+//
+//    FILE: PCF8574_bridge.ino
+//  AUTHOR: Rob Tillaart
+//    DATE: 2026-10-18
+// PURPOSE: demo binary serial bridge, host controls a bank in batches
+//     URL: https://github.com/RobTillaart/PCF8574
+//
+//  Serial carries the binary frames, so no debug output.
+//  See readme.md for the frame format.
+
+
+#include "PCF8574_bridge.h"
+
+PCF8574 PCF1(0x20);
+PCF8574 PCF2(0x21);
+PCF8574 PCF3(0x22);
+
+PCF8574_Bank bank;
+PCF8574_Bridge bridge(&bank);
+
+
+void setup()
+{
+  Serial.begin(115200);
+
+  Wire.begin();
+  Wire.setClock(400000);
+  bank.add(&PCF1);
+  bank.add(&PCF2);
+  bank.add(&PCF3);
+  bank.begin();
+
+  bridge.begin(&Serial);
+}
+
+
+void loop()
+{
+  bridge.poll();
+}
+
+
+//  -- END OF FILE --
+
@@ -0,0 +1,67 @@
+//
+//    FILE: PCF8574_callstats.ino
+//  AUTHOR: Rob Tillaart
+//    DATE: 2026-10-18
+// PURPOSE: demo call site attribution of I2C traffic
+//     URL: https://github.com/RobTillaart/PCF8574
+//
+//  build with -DPCF8574_CALLSTATS (whole build), see readme.md.
+
+
+#include "PCF8574.h"
+
+PCF8574 PCF(0x38);
+PCF8574_CallStats stats;
+
+uint32_t lastDump = 0;
+
+
+void blink()
+{
+  PCF8574_CALL(PCF, toggle(0));
+}
+
+
+void readButtons()
+{
+  uint8_t x = PCF8574_CALL(PCF, readButton8(0xF0));
+  if (x != 0xF0) PCF8574_CALL(PCF, write(1, LOW));
+}
+
+
+void setup()
+{
+  Serial.begin(115200);
+  Serial.println(__FILE__);
+  Serial.print("PCF8574_LIB_VERSION:\t");
+  Serial.println(PCF8574_LIB_VERSION);
+
+  Wire.begin();
+
+#ifndef PCF8574_CALLSTATS
+  Serial.println("build with -DPCF8574_CALLSTATS, see readme.md");
+#else
+  PCF.setCallStats(&stats);
+#endif
+  PCF.begin();        //  not wrapped => unknown
+}
+
+
+void loop()
+{
+  blink();
+  readButtons();
+  delay(10);
+
+  if (millis() - lastDump >= 5000)
+  {
+    lastDump = millis();
+    Serial.println("\nCALLER\tCOUNT\tBUSTIME");
+    stats.dump(Serial);
+    stats.reset();
+  }
+}
+
+
+//  -- END OF FILE --
+
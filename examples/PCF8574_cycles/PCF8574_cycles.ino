@@ -0,0 +1,165 @@
+//
+//    FILE: PCF8574_cycles.ino
+//  AUTHOR: Rob Tillaart
+//    DATE: 2026-10-18
+// PURPOSE: measure CPU cycles spent in the library (excluding the bus)
+//     URL: https://github.com/RobTillaart/PCF8574
+//
+//  Every API call is measured in CPU cycles, minimum of RUNS calls.
+//  The same I2C traffic is generated with raw Wire calls and subtracted,
+//  so the overhead column is the CPU cost of the library itself.
+//
+//  AVR   : Timer1 without prescaler, exact cycles (max 65535).
+//  ESP32 : cycle counter of the core.
+//  other : micros() * cycles per microsecond (indication only).
+//
+//  Without hardware: build with -DPCF8574_SIM (whole build), the device
+//  and the reference transactions then use the simulator instead of Wire.
+//  No PCF8574 or TWI is needed, so it runs on a bare board or in an AVR
+//  simulator with Timer1 (e.g. simavr), e.g.
+//    simavr -m atmega328p -f 16000000 PCF8574_cycles.ino.elf
+//
+//  Flash usage per function can be found in the .elf file, e.g.
+//    avr-nm --size-sort -C -S PCF8574_cycles.ino.elf | grep PCF8574
+
+
+#include "PCF8574.h"
+
+PCF8574 PCF(0x38);
+
+const uint8_t RUNS = 10;
+volatile uint8_t x;
+
+
+#if defined(__AVR__)
+
+void cyclesBegin()
+{
+  TCCR1A = 0;
+  TCCR1B = _BV(CS10);   //  no prescaler
+  TIMSK1 = 0;
+}
+typedef uint16_t cycles_t;    //  16 bit timer wraps correctly
+inline cycles_t cycles() { return TCNT1; }
+
+#elif defined(ESP32)
+
+void cyclesBegin() {}
+typedef uint32_t cycles_t;
+inline cycles_t cycles() { return ESP.getCycleCount(); }
+
+#else
+
+#ifndef F_CPU
+#define F_CPU       16000000UL
+#endif
+void cyclesBegin() {}
+typedef uint32_t cycles_t;
+inline cycles_t cycles() { return micros() * (F_CPU / 1000000UL); }
+
+#endif
+
+
+#ifdef PCF8574_SIM
+
+PCF8574_Sim sim;
+
+//  RAW simulator reference transactions.
+void rawWrite(uint8_t value)
+{
+  sim.write(PCF.getAddress(), &value, 1);
+}
+
+void rawRead()
+{
+  uint8_t value;
+  if (sim.read(PCF.getAddress(), value) == 1) x = value;
+}
+
+#else
+
+//  RAW I2C reference transactions.
+void rawWrite(uint8_t value)
+{
+  Wire.beginTransmission(PCF.getAddress());
+  Wire.write(value);
+  Wire.endTransmission();
+}
+
+void rawRead()
+{
+  if (Wire.requestFrom(PCF.getAddress(), (uint8_t)1) == 1) x = Wire.read();
+}
+
+#endif
+
+
+uint32_t measure(void (*f)())
+{
+  uint32_t best = 0xFFFFFFFF;
+  for (uint8_t i = 0; i < RUNS; i++)
+  {
+    cycles_t start = cycles();
+    f();
+    cycles_t duration = cycles() - start;
+    if (duration < best) best = duration;
+  }
+  return best;
+}
+
+
+void report(const char * name, void (*api)(), void (*raw)())
+{
+  uint32_t a = measure(api);
+  uint32_t r = measure(raw);
+  Serial.print(name);
+  Serial.print("\t");
+  Serial.print(a);
+  Serial.print("\t");
+  Serial.print(r);
+  Serial.print("\t");
+  Serial.println((int32_t)(a - r));
+  delay(10);
+}
+
+
+void setup()
+{
+  Serial.begin(115200);
+  Serial.println(__FILE__);
+  Serial.print("PCF8574_LIB_VERSION:\t");
+  Serial.println(PCF8574_LIB_VERSION);
+
+#ifdef PCF8574_SIM
+  Serial.println("bus:\tsimulator");
+  sim.addDevice(PCF.getAddress());
+  PCF.setSim(&sim);
+#else
+  Serial.println("bus:\tWire @400 KHz");
+  Wire.begin();
+  Wire.setClock(400000);
+#endif
+  PCF.begin();
+  cyclesBegin();
+  delay(100);
+
+  Serial.println("API\t\tcycles\traw bus\toverhead");
+  report("read8()\t", []() { x = PCF.read8(); }, rawRead);
+  report("read(3)\t", []() { x = PCF.read(3); }, rawRead);
+  report("write8()\t", []() { PCF.write8(0x55); }, []() { rawWrite(0x55); });
+  report("write(3)\t", []() { PCF.write(3, HIGH); }, []() { rawWrite(0x55); });
+  report("toggle(3)\t", []() { PCF.toggle(3); }, []() { rawWrite(0x55); });
+  report("reverse()\t", []() { PCF.reverse(); }, []() { rawWrite(0x55); });
+  report("rotateLeft(3)", []() { PCF.rotateLeft(3); }, []() { rawWrite(0x55); });
+  report("readButton8()", []() { x = PCF.readButton8(); }, []() { rawWrite(0xFF); rawRead(); rawWrite(0x55); });
+  report("select(3)\t", []() { PCF.select(3); }, []() { rawWrite(0x08); });
+}
+
+
+void loop()
+{
+}
+
+
+//  -- END OF FILE --
+
@@ -0,0 +1,46 @@
+//
+//    FILE: PCF8574_modbus.ino
+//  AUTHOR: Rob Tillaart
+//    DATE: 2026-10-18
+// PURPOSE: demo Modbus RTU slave, coils and discrete inputs on a bank
+//     URL: https://github.com/RobTillaart/PCF8574
+//
+//  Serial is the Modbus line (RS485 adapter), so no debug output.
+//  coils 0..7 and inputs 0..7    = PCF1
+//  coils 8..15 and inputs 8..15  = PCF2
+//
+//  e.g. with mbpoll on a PC:
+//    mbpoll -m rtu -a 17 -b 19200 -P none -t 0 -r 1 -c 16 /dev/ttyUSB0
+
+
+#include "PCF8574_modbus.h"
+
+PCF8574 PCF1(0x20);
+PCF8574 PCF2(0x21);
+
+PCF8574_Bank bank;
+PCF8574_Modbus modbus(&bank, 17);
+
+
+void setup()
+{
+  Serial.begin(19200);
+
+  Wire.begin();
+  bank.add(&PCF1);
+  bank.add(&PCF2);
+  bank.begin();
+
+  modbus.begin(&Serial, 19200);
+}
+
+
+void loop()
+{
+  modbus.poll();
+  bank.service();
+}
+
+
+//  -- END OF FILE --
+
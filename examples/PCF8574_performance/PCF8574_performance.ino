@@ -3,6 +3,8 @@
 //  AUTHOR: Rob Tillaart
 //    DATE: 2021-01-24
 // PURPOSE: test PCF8574 library at different I2C speeds.
+//          build with and without -DPCF8574_HEADER_ONLY (whole build)
+//          to compare size and speed of the header only mode.
 //     URL: https://github.com/RobTillaart/PCF8574
 
 
@@ -21,6 +23,11 @@ void setup()
   Serial.println(__FILE__);
   Serial.print("PCF8574_LIB_VERSION:\t");
   Serial.println(PCF8574_LIB_VERSION);
+#ifdef PCF8574_HEADER_ONLY
+  Serial.println("PCF8574_HEADER_ONLY:\t1");
+#else
+  Serial.println("PCF8574_HEADER_ONLY:\t0");
+#endif
 
   Wire.begin();
 
@@ -55,6 +62,39 @@ void setup()
     Serial.println(stop - start);
     delay(1000);
   }
+
+  //  average of 100 calls of the hot path functions.
+  Wire.setClock(400000);
+  Serial.println();
+  Serial.println("400000\t(average of 100 calls)");
+
+  start = micros();
+  for (int i = 0; i < 100; i++) x = PCF.read8();
+  stop = micros();
+  Serial.print("read8:\t");
+  Serial.println((stop - start) / 100.0);
+  delay(100);
+
+  start = micros();
+  for (int i = 0; i < 100; i++) PCF.write8(i);
+  stop = micros();
+  Serial.print("write8:\t");
+  Serial.println((stop - start) / 100.0);
+  delay(100);
+
+  start = micros();
+  for (int i = 0; i < 100; i++) PCF.write(i & 7, i & 1);
+  stop = micros();
+  Serial.print("write:\t");
+  Serial.println((stop - start) / 100.0);
+  delay(100);
+
+  start = micros();
+  for (int i = 0; i < 100; i++) PCF.toggleMask(0x55);
+  stop = micros();
+  Serial.print("toggleMask:\t");
+  Serial.println((stop - start) / 100.0);
+  delay(100);
 }
 
 
@@ -0,0 +1,108 @@
+//
+//    FILE: PCF8574_pipeline.ino
+//  AUTHOR: Rob Tillaart
+//    DATE: 2026-10-18
+// PURPOSE: benchmark compile time pipeline against hand written input path
+//     URL: https://github.com/RobTillaart/PCF8574
+//
+//  Uses the simulator as source so only the CPU time is measured,
+//  no hardware needed. Both versions should take about the same time.
+//  Build with -DPCF8574_SIM (whole build), see readme.md.
+
+
+#include "PCF8574_pipeline.h"
+
+PCF8574_Sim sim;
+PCF8574 PCF(0x20);
+
+volatile uint16_t events = 0;
+
+void onKey(uint8_t pin, bool rising)
+{
+  if (rising) events += pin;
+}
+
+
+PCF8574_Pipeline<PCF8574_PipeSource<PCF8574>,
+                 PCF8574_PipeInvert<0xFF>,
+                 PCF8574_PipeDebounce,
+                 PCF8574_PipeEdges,
+                 PCF8574_PipeDispatch<onKey> > keys(PCF);
+
+
+//  hand written equivalent
+uint8_t state = 0, ct0 = 0xFF, ct1 = 0xFF, last = 0;
+
+void handWritten()
+{
+  uint8_t value = PCF.read8() ^ 0xFF;
+  uint8_t delta = value ^ state;
+  ct0 = ~(ct0 & delta);
+  ct1 = ct0 ^ (ct1 & delta);
+  delta &= ct0 & ct1;
+  state ^= delta;
+  uint8_t changed = state ^ last;
+  uint8_t rising = changed & state;
+  last = state;
+  for (uint8_t pin = 0; changed != 0; pin++, changed >>= 1)
+  {
+    if (changed & 1) onKey(pin, (rising >> pin) & 1);
+  }
+}
+
+
+void setup()
+{
+  Serial.begin(115200);
+  Serial.println(__FILE__);
+  Serial.print("PCF8574_LIB_VERSION:\t");
+  Serial.println(PCF8574_LIB_VERSION);
+  Serial.println();
+
+#ifndef PCF8574_SIM
+  Serial.println("build with -DPCF8574_SIM, see readme.md");
+  return;
+#else
+
+  sim.addDevice(0x20);
+  PCF.setSim(&sim);
+  PCF.begin();
+
+  uint32_t start, stop;
+
+  events = 0;
+  start = micros();
+  for (uint16_t i = 0; i < 1000; i++)
+  {
+    sim.setInput(0x20, ~(i >> 3));   //  inputs change every 8 calls
+    keys.update();
+  }
+  stop = micros();
+  Serial.print("pipeline:\t");
+  Serial.print(stop - start);
+  Serial.print("\t");
+  Serial.println(events);
+
+  events = 0;
+  start = micros();
+  for (uint16_t i = 0; i < 1000; i++)
+  {
+    sim.setInput(0x20, ~(i >> 3));
+    handWritten();
+  }
+  stop = micros();
+  Serial.print("hand written:\t");
+  Serial.print(stop - start);
+  Serial.print("\t");
+  Serial.println(events);
+#endif
+}
+
+
+void loop()
+{
+}
+
+
+//  -- END OF FILE --
+
@@ -0,0 +1,210 @@
+//
+//    FILE: PCF8574_policy_compare.ino
+//  AUTHOR: Rob Tillaart
+//    DATE: 2026-10-18
+// PURPOSE: compare read policies (polling, INT, hybrid) on simulated workloads
+//     URL: https://github.com/RobTillaart/PCF8574
+//
+//  No hardware needed, runs on the simulator with a virtual clock.
+//  Build with -DPCF8574_SIM (whole build), see readme.md.
+//  Every workload is run against every policy for SIM_TIME micros.
+//
+//  reads    number of read8() calls
+//  bus%     bus utilization, BUS_READ_US per read
+//  missed   input changes never seen by a read
+//  latency  time between a change and the read that saw it (micros)
+//
+//  Note the INT policy can miss changes that revert before the read (see #48),
+//  the hybrid policy adds a slow poll as safety net.
+
+
+#include "PCF8574.h"
+#include "workload.h"
+
+
+const uint32_t SIM_TIME     = 20000000UL;   //  20 seconds
+const uint32_t BUS_READ_US  = 132;          //  read8() @100 KHz
+const uint32_t ISR_LATENCY  = 20;           //  INT edge => read starts
+
+
+struct Policy
+{
+  const char * name;
+  uint32_t pollInterval;    //  0 = no polling
+  bool     useInterrupt;
+};
+
+const Policy policies[] =
+{
+  { "poll 10ms", 10000, false },
+  { "poll 1ms ",  1000, false },
+  { "INT      ",     0, true  },
+  { "hybrid   ", 20000, true  },
+};
+
+
+PCF8574_VirtualClock vclock;
+PCF8574_Sim sim;
+PCF8574 PCF(0x20);
+
+
+struct Result
+{
+  uint32_t reads;
+  uint32_t events;
+  uint32_t missed;
+  uint32_t latMin;
+  uint32_t latMax;
+  uint32_t latSum;
+  uint32_t detected;
+  uint32_t hist[5];         //  <1ms, <5ms, <10ms, <50ms, >=50ms
+};
+
+
+//  time since the start of the run.
+uint32_t runStart = 0;
+
+uint32_t now()
+{
+  return vclock.micros() - runStart;
+}
+
+
+//  the clock never goes back, an event or read that is due
+//  while the bus is busy happens when the bus is free again.
+void waitUntil(const uint32_t t)
+{
+  if (t > now()) vclock.advance(t - now());
+}
+
+
+void run(const WorkloadType type, const Policy & policy, Result & r)
+{
+  memset(&r, 0, sizeof(r));
+  r.latMin = 0xFFFFFFFF;
+
+  Workload wl(type, 12345);
+  runStart = vclock.micros();
+  sim.setInput(0x20, 0xFF);
+  PCF.begin();
+
+  uint32_t eventTime = 0;
+  uint8_t  eventLevels = 0xFF;
+  bool     pending = false;         //  event not yet seen
+  uint32_t nextPoll = policy.pollInterval;
+  uint32_t intRead = 0xFFFFFFFF;    //  time of read triggered by INT
+
+  while (now() < SIM_TIME)
+  {
+    uint32_t tRead = intRead;
+    if ((policy.pollInterval > 0) && (nextPoll < tRead)) tRead = nextPoll;
+
+    if (wl.nextTime() <= tRead)
+    {
+      //  input change, latency counts from the time it was due.
+      waitUntil(wl.nextTime());
+      bool intBefore = sim.interrupt(0x20);
+      if (pending) r.missed++;
+      eventTime = wl.nextTime();
+      eventLevels = wl.next();
+      pending = true;
+      r.events++;
+      sim.setInput(0x20, eventLevels);
+      //  falling edge of INT
+      if (policy.useInterrupt && !intBefore && sim.interrupt(0x20) && (intRead == 0xFFFFFFFF))
+      {
+        intRead = eventTime + ISR_LATENCY;
+      }
+      continue;
+    }
+
+    //  read, starts at max(now, due) so latency includes bus busy time.
+    waitUntil(tRead);
+    if (tRead == intRead) intRead = 0xFFFFFFFF;
+    if (tRead == nextPoll) nextPoll += policy.pollInterval;
+    uint8_t value = PCF.read8();     //  advances clock with BUS_READ_US
+    r.reads++;
+    if (pending && (value == eventLevels))
+    {
+      uint32_t latency = now() - eventTime;
+      pending = false;
+      r.detected++;
+      r.latSum += latency;
+      if (latency < r.latMin) r.latMin = latency;
+      if (latency > r.latMax) r.latMax = latency;
+      if      (latency <  1000) r.hist[0]++;
+      else if (latency <  5000) r.hist[1]++;
+      else if (latency < 10000) r.hist[2]++;
+      else if (latency < 50000) r.hist[3]++;
+      else                      r.hist[4]++;
+    }
+  }
+}
+
+
+void setup()
+{
+  Serial.begin(115200);
+  Serial.println(__FILE__);
+  Serial.print("PCF8574_LIB_VERSION:\t");
+  Serial.println(PCF8574_LIB_VERSION);
+  Serial.println();
+
+#ifndef PCF8574_SIM
+  Serial.println("build with -DPCF8574_SIM, see readme.md");
+  return;
+#else
+
+  PCF8574_setClock(&vclock);
+  sim.addDevice(0x20);
+  //  every transaction costs bus time
+  PCF8574_FaultRule busTime = { 0x20, PCF8574_FAULT_STRETCH, PCF8574_FAULT_ON_ALL, 100, 0, BUS_READ_US, 0, PCF8574_SIM_FOREVER };
+  sim.addRule(busTime);
+  PCF.setSim(&sim);
+
+  for (uint8_t w = 0; w < WL_COUNT; w++)
+  {
+    Workload wl((WorkloadType)w, 1);
+    Serial.print("WORKLOAD: ");
+    Serial.println(wl.name());
+    Serial.println("policy\t\treads\tbus%\tevents\tmissed\tlat min\tlat avg\tlat max\t<1ms\t<5ms\t<10ms\t<50ms\t>=50ms");
+    for (const Policy & p : policies)
+    {
+      Result r;
+      run((WorkloadType)w, p, r);
+      Serial.print(p.name);
+      Serial.print('\t');
+      Serial.print(r.reads);
+      Serial.print('\t');
+      Serial.print(100.0 * r.reads * BUS_READ_US / SIM_TIME, 2);
+      Serial.print('\t');
+      Serial.print(r.events);
+      Serial.print('\t');
+      Serial.print(r.missed);
+      Serial.print('\t');
+      Serial.print(r.detected ? r.latMin : 0);
+      Serial.print('\t');
+      Serial.print(r.detected ? r.latSum / r.detected : 0);
+      Serial.print('\t');
+      Serial.print(r.latMax);
+      for (uint8_t i = 0; i < 5; i++)
+      {
+        Serial.print('\t');
+        Serial.print(r.hist[i]);
+      }
+      Serial.println();
+    }
+    Serial.println();
+  }
+  PCF8574_setClock(nullptr);
+#endif
+}
+
+
+void loop()
+{
+}
+
+
+//  -- END OF FILE --
+
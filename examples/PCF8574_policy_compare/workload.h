@@ -0,0 +1,114 @@
+#pragma once
+//
+//    FILE: workload.h
+//  AUTHOR: Rob Tillaart
+//    DATE: 2026-10-18
+// PURPOSE: synthetic input workloads for PCF8574_policy_compare.ino
+//     URL: https://github.com/RobTillaart/PCF8574
+//
+//  Generates a deterministic sequence of input changes (events)
+//  for a simulated PCF8574. Times are in micros.
+
+
+#include "Arduino.h"
+
+
+enum WorkloadType
+{
+  WL_BUTTONS,       //  4 buttons, pins 0..3, pressed 50..300 ms
+  WL_ENCODER,       //  rotary encoder, pins 4 and 5, 2..20 ms per step
+  WL_BURST,         //  bursts of 10 fast toggles on pin 6
+  WL_NOISE,         //  short LOW glitches on pin 7
+  WL_COUNT
+};
+
+
+class Workload
+{
+public:
+  Workload(const WorkloadType type, const uint32_t seed)
+  : _type {type}, _seed {seed | 1}
+  {
+    _next = _random(1000, 10000);
+  }
+
+  const char * name() const
+  {
+    const char * names[WL_COUNT] = { "buttons", "encoder", "burst", "noise" };
+    return names[_type];
+  }
+
+  uint32_t nextTime() const { return _next; };
+  uint8_t  levels() const   { return _levels; };
+
+  //  applies the next event, returns the new levels.
+  uint8_t next()
+  {
+    uint32_t now = _next;
+    switch (_type)
+    {
+      case WL_BUTTONS:
+        if (_levels == 0xFF)
+        {
+          _levels &= ~(1 << _random(0, 4));
+          _next = now + _random(50000, 300000);
+        }
+        else
+        {
+          _levels = 0xFF;
+          _next = now + _random(200000, 2000000);
+        }
+        break;
+
+      case WL_ENCODER:
+        {
+          //  gray code on pins 4, 5
+          const uint8_t gray[4] = { 0x00, 0x10, 0x30, 0x20 };
+          _step = (_step + ((_count & 0x20) ? 3 : 1)) & 3;   //  change direction now and then
+          _levels = 0xCF | gray[_step];
+          _count++;
+          _next = now + _random(2000, 20000);
+        }
+        break;
+
+      case WL_BURST:
+        _levels ^= 0x40;
+        _count++;
+        if (_count % 10) _next = now + _random(200, 2000);
+        else             _next = now + _random(300000, 600000);
+        break;
+
+      case WL_NOISE:
+        _levels ^= 0x80;
+        if (_levels & 0x80) _next = now + _random(10000, 100000);
+        else                _next = now + _random(20, 300);
+        break;
+
+      default:
+        _next = 0xFFFFFFFF;
+    }
+    return _levels;
+  }
+
+
+private:
+  WorkloadType _type;
+  uint32_t _seed;
+  uint32_t _next;
+  uint8_t  _levels {0xFF};
+  uint8_t  _step {0};
+  uint32_t _count {0};
+
+  //  xorshift32, lo..hi-1
+  uint32_t _random(const uint32_t lo, const uint32_t hi)
+  {
+    _seed ^= _seed << 13;
+    _seed ^= _seed >> 17;
+    _seed ^= _seed << 5;
+    return lo + _seed % (hi - lo);
+  }
+};
+
+
+//  -- END OF FILE --
+
@@ -0,0 +1,68 @@
+//
+//    FILE: PCF8574_port.ino
+//  AUTHOR: Rob Tillaart
+//    DATE: 2026-10-18
+// PURPOSE: demo common expander port interface
+//     URL: https://github.com/RobTillaart/PCF8574
+
+
+#include "PCF8574.h"
+
+PCF8574 PCF1(0x20);
+PCF8574 PCF2(0x21);
+
+
+//  static dispatch, works for every port type, no virtual calls.
+template <class T>
+void runningLight(T & port)
+{
+  for (uint8_t i = 0; i < T::portWidth(); i++)
+  {
+    port.portWrite(1U << i);
+    delay(50);
+  }
+  port.portClear(port.portMask());
+}
+
+
+//  dynamic dispatch, e.g. for a list of mixed expanders.
+ExpanderPortAdapter<PCF8574> port1(PCF1);
+ExpanderPortAdapter<PCF8574> port2(PCF2);
+ExpanderPortV * ports[] = { &port1, &port2 };
+
+
+void setup()
+{
+  Serial.begin(115200);
+  Serial.println(__FILE__);
+  Serial.print("PCF8574_LIB_VERSION:\t");
+  Serial.println(PCF8574_LIB_VERSION);
+
+  Wire.begin();
+  PCF1.begin();
+  PCF2.begin();
+
+  Serial.print("width:\t");
+  Serial.println(PCF1.portWidth());
+  Serial.print("direction register:\t");
+  Serial.println(PCF1.portHas(EXPANDER_CAP_DIRECTION));
+}
+
+
+void loop()
+{
+  runningLight(PCF1);
+
+  for (auto port : ports)
+  {
+    port->portUpdate(0x0F, 0x05);   //  lower nibble only
+    Serial.print(port->portValueOut(), HEX);
+    Serial.print('\t');
+  }
+  Serial.println();
+  delay(1000);
+}
+
+
+//  -- END OF FILE --
+
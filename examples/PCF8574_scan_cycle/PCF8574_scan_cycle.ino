@@ -0,0 +1,77 @@
+//
+//    FILE: PCF8574_scan_cycle.ino
+//  AUTHOR: Rob Tillaart
+//    DATE: 2026-10-18
+// PURPOSE: demo PLC style scan cycle with cycle time statistics
+//     URL: https://github.com/RobTillaart/PCF8574
+//
+//  PCF1 = 8 buttons (inputs), PCF2 = 8 LEDs (outputs)
+//  button n toggles LED n (on the press).
+
+
+#include "PCF8574_scan.h"
+
+PCF8574 PCF1(0x20);
+PCF8574 PCF2(0x21);
+
+PCF8574_Bank bank;
+
+uint8_t lastButtons = 0xFF;
+
+
+void logic(const uint8_t * inputs, uint8_t * outputs)
+{
+  uint8_t pressed = lastButtons & ~inputs[0];  //  HIGH to LOW
+  lastButtons = inputs[0];
+  outputs[0] = 0xFF;                           //  keep inputs HIGH
+  outputs[1] ^= pressed;
+}
+
+
+PCF8574_ScanCycle plc(&bank, logic);
+
+
+void setup()
+{
+  Serial.begin(115200);
+  Serial.println(__FILE__);
+  Serial.print("PCF8574_LIB_VERSION:\t");
+  Serial.println(PCF8574_LIB_VERSION);
+
+  Wire.begin();
+  bank.add(&PCF1);
+  bank.add(&PCF2);
+  bank.begin();
+
+  plc.begin();
+  plc.setPeriod(10000);    //  100 scans per second
+  plc.setWatchdog(5000);
+}
+
+
+void loop()
+{
+  plc.update();
+
+  static uint32_t lastPrint = 0;
+  if (millis() - lastPrint >= 1000)
+  {
+    lastPrint = millis();
+    Serial.print(plc.cycles());
+    Serial.print("\t");
+    Serial.print(plc.minCycle());
+    Serial.print("\t");
+    Serial.print(plc.avgCycle(), 1);
+    Serial.print("\t");
+    Serial.print(plc.maxCycle());
+    Serial.print("\t");
+    Serial.print(plc.busShare(), 1);
+    Serial.print("%\t");
+    Serial.println(plc.overruns());
+    plc.resetStatistics();
+  }
+}
+
+
+//  -- END OF FILE --
+
@@ -0,0 +1,77 @@
+//
+//    FILE: PCF8574_sleep.ino
+//  AUTHOR: Rob Tillaart
+//    DATE: 2026-10-18
+// PURPOSE: demo power down sleep, wake on INT of the PCF8574's
+//     URL: https://github.com/RobTillaart/PCF8574
+//
+// TEST SETUP (AVR)
+//   Connect the INT pins of both PCF8574 to UNO pin 2 (open drain, wired OR)
+//   Place a pull up resistor 4K7 between pin 2 and 5V
+
+
+#include "PCF8574_bank.h"
+#include <avr/sleep.h>
+
+PCF8574 PCF1(0x20);   //  buttons, INT connected
+PCF8574 PCF2(0x21);   //  LEDs, no INT
+
+PCF8574_Bank bank;
+
+const int IRQPIN = 2;
+
+
+void pcf_irq()
+{
+  //  only wakes up the processor
+}
+
+
+void setup()
+{
+  Serial.begin(115200);
+  Serial.println(__FILE__);
+  Serial.print("PCF8574_LIB_VERSION:\t");
+  Serial.println(PCF8574_LIB_VERSION);
+
+  Wire.begin();
+
+  bank.add(&PCF1);
+  bank.add(&PCF2);
+  bank.begin();
+  bank.setWakeMask(0x0003);   //  read both, PCF2 to verify its outputs.
+
+  pinMode(IRQPIN, INPUT_PULLUP);
+  attachInterrupt(digitalPinToInterrupt(IRQPIN), pcf_irq, FALLING);
+}
+
+
+void loop()
+{
+  Serial.flush();
+  bank.sleep();
+  set_sleep_mode(SLEEP_MODE_PWR_DOWN);
+  sleep_mode();
+
+  //  woken up by INT
+  uint16_t changed = bank.wake();
+  if (changed & 0x0001)
+  {
+    //  mirror buttons on the LEDs
+    PCF2.write8(PCF1.value());
+  }
+  //  outputs lost, e.g. brown out of the PCF8574's
+  if (bank.invalid() != 0)
+  {
+    bank.resync();
+  }
+  Serial.print(bank.wakeCount());
+  Serial.print('\t');
+  Serial.print(changed, HEX);
+  Serial.print('\t');
+  Serial.println(bank.awakeTime());
+}
+
+
+//  -- END OF FILE --
+
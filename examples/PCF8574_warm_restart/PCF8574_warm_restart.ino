@@ -0,0 +1,51 @@
+//
+//    FILE: PCF8574_warm_restart.ino
+//  AUTHOR: Rob Tillaart
+//    DATE: 2026-10-18
+// PURPOSE: demo keeping the outputs through a (watchdog) reset
+//     URL: https://github.com/RobTillaart/PCF8574
+//
+//  press reset, the running light continues without glitch.
+//  build with -DPCF8574_RETAIN (whole build), see readme.md.
+
+
+#include "PCF8574.h"
+
+PCF8574 PCF(0x38);
+
+//  not cleared at startup
+PCF8574_Retain retain PCF8574_NOINIT;
+
+
+void setup()
+{
+  Serial.begin(115200);
+  Serial.println(__FILE__);
+  Serial.print("PCF8574_LIB_VERSION:\t");
+  Serial.println(PCF8574_LIB_VERSION);
+
+  Wire.begin();
+
+#ifndef PCF8574_RETAIN
+  Serial.println("build with -DPCF8574_RETAIN, see readme.md");
+#else
+  PCF.setRetain(&retain);
+#endif
+  PCF.begin(0x01);
+#ifdef PCF8574_RETAIN
+  Serial.print(PCF.isWarmStart() ? "WARM" : "COLD");
+  Serial.print("\t");
+#endif
+  Serial.println(PCF.valueOut(), HEX);
+}
+
+
+void loop()
+{
+  PCF.rotateLeft();
+  delay(250);
+}
+
+
+//  -- END OF FILE --
+
@@ -35,11 +35,50 @@
 
 #include "Arduino.h"
 #include "PCF8574.h"
+#include "PCF8574_board.h"
+#include "PCF8574_bank.h"
+#include "PCF8574_power.h"
+#include "PCF8574_selftest.h"
+#include "PCF8574_modbus.h"
+#include "PCF8574_bridge.h"
+#include "PCF8574_scan.h"
+#include "PCF8574_logic.h"
+#include "PCF8574_vm.h"
+#include "PCF8574_pipeline.h"
+
+//  host only, two thread snapshot stress test.
+#if !defined(__AVR__)
+#include <thread>
+#include <atomic>
+#endif
 
 
 PCF8574 PCF(0x38);
 
 
+//  simulated devices 0x20 .. 0x20 + count - 1 added to the bank, returns bank.begin().
+static bool simBank(PCF8574_Sim & sim, PCF8574 * dev, const uint8_t count, PCF8574_Bank & bank)
+{
+  for (uint8_t i = 0; i < count; i++)
+  {
+    sim.addDevice(0x20 + i);
+    dev[i].setSim(&sim);
+    bank.add(&dev[i]);
+  }
+  return bank.begin();
+}
+
+
+//  appends the CRC16 (low byte first) to the frame, returns the new length.
+static uint8_t appendCRC(uint8_t * frame, const uint8_t length)
+{
+  uint16_t crc = PCF8574_crc16(frame, length);
+  frame[length]     = crc & 0xFF;
+  frame[length + 1] = crc >> 8;
+  return length + 2;
+}
+
+
 unittest_setup()
 {
   fprintf(stderr, "PCF8574_LIB_VERSION: %s\n", (char *) PCF8574_LIB_VERSION);
@@ -106,6 +145,1315 @@ unittest(test_address)
 }
 
 
+//  constexpr at namespace scope, used as template argument.
+constexpr PCF8574_PinDef boardPins[] =
+{
+  { 0, 0, PCF8574_PIN_OUTPUT | PCF8574_PIN_INVERTED },
+  { 0, 3, PCF8574_PIN_INPUT },
+  { 1, 7, PCF8574_PIN_OUTPUT },
+  { 1, 2, PCF8574_PIN_INPUT  | PCF8574_PIN_INVERTED },
+};
+
+
+unittest(test_board)
+{
+  const PCF8574_PinDef * pins = boardPins;
+
+  assertEqual(0x08, PCF8574_buttonMask(pins, 4, 0));
+  assertEqual(0x01, PCF8574_outputMask(pins, 4, 0));
+  assertEqual(0x01, PCF8574_invertMask(pins, 4, 0));
+  assertEqual(0xFF, PCF8574_initialValue(pins, 4, 0));
+
+  assertEqual(0x04, PCF8574_buttonMask(pins, 4, 1));
+  assertEqual(0x80, PCF8574_outputMask(pins, 4, 1));
+  //  unused lines HIGH, output 7 inactive LOW
+  assertEqual(0x7F, PCF8574_initialValue(pins, 4, 1));
+
+  assertTrue(PCF8574_boardValid(pins, 4, 2));
+  assertFalse(PCF8574_boardValid(pins, 4, 1));
+
+  const PCF8574_PinDef twice[] = { { 0, 1, 0 }, { 0, 1, PCF8574_PIN_INPUT } };
+  assertFalse(PCF8574_boardValid(twice, 2, 1));
+
+  //  compile time mask table
+  typedef PCF8574_BoardMasks<boardPins, 4, 2> Masks;
+  static_assert(Masks::masks[1].initialValue == 0x7F, "compile time");
+  assertEqual(0x08, Masks::masks[0].buttonMask);
+  assertEqual(0x04, Masks::masks[1].buttonMask);
+
+  PCF8574 devices[] = { PCF8574(0x38), PCF8574(0x39) };
+  PCF8574_BoardOf<boardPins, 4, 2> board(devices);
+  assertEqual(2, board.deviceCount());
+  assertEqual(4, board.pinCount());
+  assertEqual(&devices[1], board.device(2));
+  assertNull(board.device(4));
+
+  assertEqual(0, board.read(4));
+  int PINerror = PCF8574_PIN_ERROR;
+  assertEqual(PINerror, board.lastError());
+  assertEqual(PCF8574_BOARD_NONE, board.lastErrorDevice());
+
+  //  error of the device that failed
+  PCF8574_Sim sim;
+  sim.addDevice(0x38);
+  sim.addDevice(0x39);
+  devices[0].setSim(&sim);
+  devices[1].setSim(&sim);
+  assertTrue(board.begin());
+  assertEqual(0xFF, sim.getLatch(0x38));
+  assertEqual(0x7F, sim.getLatch(0x39));
+  assertEqual(0x04, devices[1].getButtonMask());
+
+  PCF8574_FaultRule nack = { 0x39, PCF8574_FAULT_NACK, PCF8574_FAULT_ON_ALL, 100, 0, 0, 0, PCF8574_SIM_FOREVER };
+  sim.addRule(nack);
+  board.write(2, HIGH);
+  assertEqual(2, board.lastError());
+  assertEqual(1, board.lastErrorDevice());
+  assertFalse(board.begin());
+  int I2Cerror = PCF8574_I2C_ERROR;
+  assertEqual(I2Cerror, board.lastError());
+  assertEqual(1, board.lastErrorDevice());
+}
+
+
+unittest(test_callstats)
+{
+  PCF8574_CallStats stats;
+  assertEqual(0, stats.size());
+
+  stats.record(10);
+  stats.setCaller("a.ino", 12);
+  stats.record(20);
+  stats.record(30);
+  stats.setCaller("b.ino", 12);
+  stats.record(40);
+  stats.setCaller(nullptr, 0);
+  stats.record(50);
+
+  assertEqual(3, stats.size());
+  assertNull(stats.entry(0).file);
+  assertEqual(2, stats.entry(0).count);
+  assertEqual(60, stats.entry(0).busTime);
+  assertEqual(12, stats.entry(1).line);
+  assertEqual(2, stats.entry(1).count);
+  assertEqual(50, stats.entry(1).busTime);
+  assertEqual(1, stats.entry(2).count);
+  assertEqual(0, stats.dropped());
+
+  PCF8574 PCF(0x38);
+  assertNull(PCF.getCallStats());
+  PCF.setCallStats(&stats);
+  stats.reset();
+  PCF8574_CALL(PCF, write8(0x55));
+  assertEqual(1, stats.size());
+  assertEqual(1, stats.entry(0).count);
+  assertEqual(0x55, PCF8574_CALL(PCF, valueOut()));
+
+  //  nested scope restores the outer caller
+  stats.setCaller(nullptr, 0);
+  const char * outerFile = "outer.ino";
+  {
+    PCF8574_CallerScope outer(&stats, outerFile, 1);
+    {
+      PCF8574_CallerScope inner(&stats, "inner.ino", 2);
+      assertEqual(2, stats.getCallerLine());
+    }
+    assertEqual(1, stats.getCallerLine());
+    assertEqual(outerFile, stats.getCallerFile());
+  }
+  assertNull(stats.getCallerFile());
+
+  //  count does not wrap at 16 bit
+  stats.reset();
+  for (uint32_t i = 0; i < 70000; i++) stats.record(0);
+  assertEqual(70000, stats.entry(0).count);
+}
+
+
+unittest(test_bank_snapshot)
+{
+  PCF8574 PCF1(0x38);
+  PCF8574 PCF2(0x39);
+  PCF8574_Bank bank;
+  uint8_t in[2], out[2];
+
+  assertEqual(0, bank.size());
+  assertTrue(bank.add(&PCF1));
+  assertTrue(bank.add(&PCF2));
+  assertFalse(bank.add(nullptr));
+  assertEqual(2, bank.size());
+  assertEqual(&PCF2, bank.device(1));
+  assertNull(bank.device(2));
+
+  uint8_t seq = bank.sequence();
+  PCF1.write8(0x12);
+  PCF2.write8(0x34);
+  //  not published yet
+  assertTrue(bank.snapshot(in, out));
+  assertEqual(0, out[0]);
+
+  bank.publish();
+  assertEqual(2, (uint8_t)(bank.sequence() - seq));
+  assertTrue(bank.snapshot(in, out));
+  assertEqual(0x12, out[0]);
+  assertEqual(0x34, out[1]);
+  assertTrue(bank.snapshot(in, nullptr));
+}
+
+
+#if !defined(__AVR__)
+//  writer publishes equal inputs for all devices, a reader on another thread
+//  may never get a mix of two publishes.
+unittest(test_bank_snapshot_threads)
+{
+  assertMoreOrEqual(sizeof(PCF8574_Seq), 2);
+
+  PCF8574_Sim sim;
+  PCF8574 dev[PCF8574_SIM_DEVICES] = { PCF8574(0x20), PCF8574(0x21), PCF8574(0x22), PCF8574(0x23),
+                                       PCF8574(0x24), PCF8574(0x25), PCF8574(0x26), PCF8574(0x27) };
+  PCF8574_Bank bank;
+  simBank(sim, dev, PCF8574_SIM_DEVICES, bank);
+
+  std::atomic<bool> done(false);
+  std::atomic<uint32_t> good(0);
+  std::atomic<uint32_t> torn(0);
+
+  std::thread reader([&]()
+  {
+    uint8_t in[PCF8574_SIM_DEVICES];
+    while (! done)
+    {
+      if (! bank.snapshot(in, nullptr, 0)) continue;
+      bool equal = true;
+      for (int i = 1; i < PCF8574_SIM_DEVICES; i++) equal &= (in[i] == in[0]);
+      if (equal) good++;
+      else       torn++;
+    }
+  });
+
+  for (uint32_t n = 0; n < 200000; n++)
+  {
+    for (int i = 0; i < PCF8574_SIM_DEVICES; i++) sim.setInput(0x20 + i, n);
+    bank.read();
+  }
+  done = true;
+  reader.join();
+
+  assertEqual(0, (uint32_t) torn);
+  assertMore((uint32_t) good, 0);
+}
+#endif
+
+
+unittest(test_bank_readahead)
+{
+  PCF8574 PCF1(0x38);
+  PCF8574 PCF2(0x39);
+  PCF8574_Bank bank;
+  bank.add(&PCF1);
+  bank.add(&PCF2);
+
+  assertEqual(10000, bank.getMaxAge());
+  bank.setMaxAge(500);
+  assertEqual(500, bank.getMaxAge());
+
+  //  never read => unknown age => stale
+  assertEqual(PCF8574_AGE_UNKNOWN, bank.age(0));
+  assertEqual(PCF8574_AGE_UNKNOWN, bank.age(2));
+  //  failing reads (test environment) do not starve the other devices.
+  assertEqual(0, bank.service());
+  assertEqual(1, bank.service());
+  assertEqual(0, bank.service());
+  assertEqual(0, bank.value(0));
+}
+
+
+unittest(test_bank_sample)
+{
+  PCF8574 PCF1(0x38);
+  PCF8574 PCF2(0x39);
+  PCF8574 PCF3(0x3A);
+  PCF8574_Bank bank;
+  bank.add(&PCF1);
+  bank.add(&PCF2);
+  bank.add(&PCF3);
+
+  assertEqual(0, bank.getGroup(0));
+  bank.setGroup(0, 1);
+  bank.setGroup(2, 1);
+  assertEqual(1, bank.getGroup(2));
+  assertEqual(0, bank.getGroup(1));
+  assertEqual(0, bank.getGroup(5));
+
+  //  test environment, all reads fail.
+  assertEqual(3, bank.sample());
+  assertEqual(0, bank.maxSkew());
+}
+
+
+unittest(test_bank_commit)
+{
+  PCF8574 PCF1(0x38);
+  PCF8574 PCF2(0x39);
+  PCF8574_Bank bank;
+  bank.add(&PCF1);
+  bank.add(&PCF2);
+  PCF1.write8(0x00);
+  PCF2.write8(0x00);
+
+  bank.stage(0, 0x0F);
+  bank.stage(1, 0x00);    //  unchanged => no write
+  assertEqual(0x0F, bank.staged(0));
+  //  staged values are not visible
+  assertEqual(0x00, PCF1.valueOut());
+
+  assertEqual(0, bank.commit());
+  assertEqual(0x0F, PCF1.valueOut());
+  assertEqual(0x00, PCF2.valueOut());
+  assertEqual(0, bank.commitSkew());
+
+  bank.stage(1, 0xF0);
+  bank.discard();
+  assertEqual(0x00, bank.staged(1));
+  assertEqual(0, bank.commit());
+  assertEqual(0x00, PCF2.valueOut());
+}
+
+
+unittest(test_bank_sleep)
+{
+  PCF8574 PCF1(0x38);
+  PCF8574 PCF2(0x39);
+  PCF8574_Bank bank;
+  bank.add(&PCF1);
+  bank.add(&PCF2);
+
+  assertEqual(0xFFFF, bank.getWakeMask());
+  bank.setWakeMask(0x0001);
+  assertEqual(0x0001, bank.getWakeMask());
+
+  //  test environment, reads fail => nothing changed, nothing invalid
+  assertEqual(0, bank.wake());
+  assertEqual(1, bank.wakeCount());
+  assertEqual(0, bank.invalid());
+  assertEqual(0, bank.resync());
+  bank.sleep();
+
+  //  PCF1 value() == 0
+  PCF1.write8(0x00);
+  assertTrue(PCF1.isOutputValid());
+  PCF1.write8(0xF0);
+  assertTrue(PCF1.isOutputValid());
+}
+
+
+unittest(test_warm_restart)
+{
+  PCF8574_Retain retain;
+  memset(&retain, 0, sizeof(retain));
+
+  PCF8574 PCF1(0x38);
+  PCF1.setRetain(&retain);
+  assertTrue(PCF1.begin());
+  assertFalse(PCF1.isWarmStart());
+  PCF1.write8(0x0F);
+  PCF1.setButtonMask(0x0C);
+
+  //  "reset"
+  PCF8574 PCF2(0x38);
+  PCF2.setRetain(&retain);
+  PCF2.setButtonMask(0xFF);    //  before begin => does not touch retain
+  assertTrue(PCF2.begin(0xFF));
+  assertTrue(PCF2.isWarmStart());
+  assertEqual(0x0F, PCF2.valueOut());
+  assertEqual(0x0C, PCF2.getButtonMask());
+
+  //  other address => cold start
+  PCF8574 PCF3(0x39);
+  PCF3.setRetain(&retain);
+  assertTrue(PCF3.begin(0xFF));
+  assertFalse(PCF3.isWarmStart());
+  assertEqual(0xFF, PCF3.valueOut());
+
+  //  corrupted retain block => cold start, every single bit of every field
+  PCF8574 PCF4(0x39);
+  PCF4.setRetain(&retain);
+  assertTrue(PCF4.begin());
+  PCF4.write8(0x33);
+  PCF8574_Retain valid = retain;
+  for (uint8_t b = 0; b < 56; b++)
+  {
+    retain = valid;
+    if      (b < 16) retain.magic      ^= (1U << b);
+    else if (b < 24) retain.address    ^= (1U << (b - 16));
+    else if (b < 32) retain.dataOut    ^= (1U << (b - 24));
+    else if (b < 40) retain.buttonMask ^= (1U << (b - 32));
+    else             retain.crc        ^= (1U << (b - 40));
+    //  another device that matches the corrupted address
+    PCF8574 PCF5(retain.address);
+    PCF5.setRetain(&retain);
+    assertTrue(PCF5.begin(0xFF));
+    assertFalse(PCF5.isWarmStart());
+    assertEqual(0xFF, PCF5.valueOut());
+  }
+  retain = valid;
+  PCF8574 PCF6(0x39);
+  PCF6.setRetain(&retain);
+  assertTrue(PCF6.begin(0xFF));
+  assertTrue(PCF6.isWarmStart());
+  assertEqual(0x33, PCF6.valueOut());
+
+  //  CRC16 Modbus check value
+  const uint8_t check[9] = { '1', '2', '3', '4', '5', '6', '7', '8', '9' };
+  assertEqual(0x4B37, PCF8574_crc16(check, 9));
+}
+
+
+unittest(test_port)
+{
+  PCF8574 PCF(0x38);
+  assertEqual(8, PCF8574::portWidth());
+  assertEqual(0x00FF, PCF.portMask());
+  assertTrue(PCF.portHas(EXPANDER_CAP_QUASI_BIDIR));
+  assertFalse(PCF.portHas(EXPANDER_CAP_DIRECTION));
+
+  PCF.portWrite(0xA5);
+  assertEqual(0xA5, PCF.valueOut());
+  PCF.portUpdate(0x0F, 0x03);
+  assertEqual(0xA3, PCF.portValueOut());
+  PCF.portSet(0x40);
+  assertEqual(0xE3, PCF.valueOut());
+  PCF.portClear(0x03);
+  assertEqual(0xE0, PCF.valueOut());
+  PCF.portToggle(0xFF);
+  assertEqual(0x1F, PCF.valueOut());
+
+  ExpanderPortAdapter<PCF8574> adapter(PCF);
+  ExpanderPortV * port = &adapter;
+  assertEqual(8, port->portWidth());
+  port->portUpdate(0xF0, 0x50);
+  assertEqual(0x5F, PCF.valueOut());
+}
+
+
+unittest(test_sim)
+{
+  PCF8574_Sim sim;
+  assertTrue(sim.addDevice(0x20));
+  assertFalse(sim.addDevice(0x20));
+
+  PCF8574 PCF(0x20);
+  PCF.setSim(&sim);
+  assertEqual(&sim, PCF.getSim());
+  assertTrue(PCF.begin(0xF0));
+  assertEqual(0xF0, sim.getLatch(0x20));
+
+  //  quasi bidirectional, external LOW wins
+  sim.setInput(0x20, 0x7F);
+  assertTrue(sim.interrupt(0x20));
+  assertEqual(0x70, PCF.read8());
+  assertFalse(sim.interrupt(0x20));
+  assertEqual(PCF8574_OK, PCF.lastError());
+
+  //  device not simulated
+  PCF8574 PCF2(0x21);
+  PCF2.setSim(&sim);
+  assertFalse(PCF2.begin());
+}
+
+
+unittest(test_sim_faults)
+{
+  PCF8574_Sim sim;
+  sim.addDevice(0x20);
+  PCF8574 PCF(0x20);
+  PCF.setSim(&sim);
+
+  //  transactions 2 and 3 NACK, stuck line 0 on all reads.
+  PCF8574_FaultRule nack  = { 0x20, PCF8574_FAULT_NACK, PCF8574_FAULT_ON_ALL, 100, 0, 0, 2, 3 };
+  PCF8574_FaultRule stuck = { PCF8574_SIM_ALL, PCF8574_FAULT_STUCK_LOW, PCF8574_FAULT_ON_READ, 100, 0x01, 0, 0, PCF8574_SIM_FOREVER };
+  assertTrue(sim.addRule(nack));
+  assertTrue(sim.addRule(stuck));
+
+  PCF.write8(0xFF);                      //  0
+  assertEqual(0xFE, PCF.read8());        //  1
+  PCF.write8(0x00);                      //  2  NACK
+  assertEqual(0xFF, sim.getLatch(0x20));
+  assertNotEqual(PCF8574_OK, PCF.lastError());
+  assertEqual(0xFE, PCF.read8());        //  3  NACK, last value
+  int I2Cerror = PCF8574_I2C_ERROR;
+  assertEqual(I2Cerror, PCF.lastError());
+  PCF.write8(0x0F);                      //  4
+  assertEqual(0x0E, PCF.read8());        //  5
+  assertEqual(6, sim.transactions(0x20));
+  assertEqual(5, sim.injected());
+
+  //  same seed => same faults
+  PCF8574_FaultRule random = { 0x20, PCF8574_FAULT_SHORT_READ, PCF8574_FAULT_ON_READ, 50, 0, 0, 0, PCF8574_SIM_FOREVER };
+  sim.clearRules();
+  sim.addRule(random);
+  uint16_t run[2] = { 0, 0 };
+  for (int r = 0; r < 2; r++)
+  {
+    sim.setSeed(42);
+    for (int i = 0; i < 16; i++)
+    {
+      PCF.read8();
+      if (PCF.lastError() != PCF8574_OK) run[r] |= (1 << i);
+    }
+  }
+  assertEqual(run[0], run[1]);
+  assertNotEqual(0, run[0]);
+  assertNotEqual(0xFFFF, run[0]);
+}
+
+
+unittest(test_virtual_clock)
+{
+  PCF8574_VirtualClock clock(1000);
+  PCF8574_setClock(&clock);
+  assertEqual(1000, PCF8574_micros());
+  PCF8574_delayMicros(500);
+  assertEqual(1500, PCF8574_micros());
+  clock.advance(10000000);
+  assertEqual(10001, PCF8574_millis());
+  clock.advance(600);
+  assertEqual(10002, PCF8574_millis());
+  PCF8574_delayMicros(2999);
+  assertEqual(10005, PCF8574_millis());
+  assertEqual(10005099, PCF8574_micros());
+
+  //  millis do not wrap with micros
+  clock.set(0xFFFFFC18);      //  2^32 - 1000 us
+  uint32_t ms = PCF8574_millis();
+  clock.advance(2000);
+  assertEqual(1000, PCF8574_micros());
+  assertEqual(ms + 2, PCF8574_millis());
+
+  //  elapse only moves a virtual clock
+  PCF8574_elapse(1000);
+  assertEqual(ms + 3, PCF8574_millis());
+
+  //  read ahead in simulated time
+  PCF8574_Sim sim;
+  sim.addDevice(0x20);
+  PCF8574 PCF(0x20);
+  PCF.setSim(&sim);
+  PCF8574_Bank bank;
+  bank.add(&PCF);
+  bank.setMaxAge(1000);
+
+  assertEqual(0, bank.service());
+  assertEqual(0, bank.age(0));
+  clock.advance(999);
+  assertEqual(PCF8574_BANK_NONE, bank.service());
+  clock.advance(1);
+  assertEqual(1000, bank.age(0));
+  assertEqual(0, bank.service());
+
+  //  clock stretching is simulated time too
+  PCF8574_FaultRule stretch = { 0x20, PCF8574_FAULT_STRETCH, PCF8574_FAULT_ON_ALL, 100, 0, 250, 0, PCF8574_SIM_FOREVER };
+  sim.addRule(stretch);
+  uint32_t start = PCF8574_micros();
+  PCF.read8();
+  assertEqual(250, PCF8574_micros() - start);
+
+  PCF8574_setClock(nullptr);
+}
+
+
+unittest(test_power_scheduler)
+{
+  PCF8574_VirtualClock clock(0);
+  PCF8574_setClock(&clock);
+  PCF8574_Sim sim;
+  sim.addDevice(0x20);
+  PCF8574 PCF(0x20);
+  PCF.setSim(&sim);
+  PCF.begin(0xFF);
+
+  //  active LOW relay board, 0xFF == all off.
+  PCF8574_PowerScheduler power(&PCF, 200, 0);
+  assertEqual(0, power.getFrameDelay());
+  power.setActiveLow(0xFF);
+  for (int pin = 0; pin < 8; pin++) power.setCurrent(pin, 70);
+  power.setCurrent(7, 250);    //  over budget, gets own frame
+  assertEqual(250, power.getCurrent(7));
+  assertEqual(0, power.getCurrent(8));
+
+  uint8_t frames[8];
+  //  all on: 250 | 70+70 | 70+70 | 70+70 | 70
+  assertEqual(5, power.plan(0x00, frames));
+  assertEqual(0x7F, frames[0]);
+  assertEqual(0x00, frames[4]);
+  for (int f = 1; f < 5; f++)
+  {
+    assertEqual(0, frames[f] & ~frames[f - 1]);   //  only switching on
+  }
+
+  //  streamed in one transaction
+  uint32_t n = sim.transactions(0x20);
+  assertEqual(5, power.write8(0x00));
+  assertEqual(5, power.lastFrames());
+  assertEqual(n + 1, sim.transactions(0x20));
+  assertEqual(0x00, sim.getLatch(0x20));
+  assertEqual(0x00, PCF.valueOut());
+
+  //  turn offs and a single turn on fit in one frame
+  assertEqual(1, power.write8(0xFE));
+  assertEqual(0xFE, sim.getLatch(0x20));
+
+  //  separate writes with delay, e.g. relay coils
+  PCF8574_PowerScheduler relays(&PCF, 200, 10000);
+  assertEqual(10000, relays.getFrameDelay());
+  power.setFrameDelay(1000);
+  n = sim.transactions(0x20);
+  assertEqual(2, power.write8(0xF0));   //  70+70 | 70
+  assertEqual(n + 2, sim.transactions(0x20));
+  assertEqual(1000, power.lastLatency());
+  assertEqual(0xF0, PCF.valueOut());
+
+  //  nothing switches on
+  assertEqual(1, power.write8(0xFF));
+
+  //  exact, first fit decreasing needs 3 frames: 5+4 | 3+3+3 | 2
+  PCF8574_PowerScheduler exact(&PCF, 10, 0);
+  exact.setActiveLow(0xFF);
+  const uint16_t current[6] = { 5, 4, 3, 3, 3, 2 };
+  for (int pin = 0; pin < 6; pin++) exact.setCurrent(pin, current[pin]);
+  assertEqual(2, exact.plan(0xC0, frames));
+  assertEqual(0xC0, frames[1]);
+  for (int f = 0; f < 2; f++)
+  {
+    uint8_t before = (f == 0) ? 0xFF : frames[f - 1];
+    uint8_t on = before & ~frames[f];     //  switched on in this frame
+    uint16_t sum = 0;
+    for (int pin = 0; pin < 6; pin++) if (on & (1 << pin)) sum += current[pin];
+    assertEqual(10, sum);
+  }
+  PCF8574_setClock(nullptr);
+}
+
+
+unittest(test_interlock)
+{
+  PCF8574_Interlock interlock;
+  assertEqual(256, interlock.allowedCount());
+  //  H-bridge legs on pin 0 and 1, active LOW, never both on.
+  interlock.forbid(0x03, 0x00);
+  assertEqual(192, interlock.allowedCount());
+  assertFalse(interlock.isAllowed(0xFC));
+  assertTrue(interlock.isAllowed(0xFD));
+
+  PCF8574_Sim sim;
+  sim.addDevice(0x20);
+  PCF8574 PCF(0x20);
+  PCF.setSim(&sim);
+  PCF.setInterlock(&interlock);
+  assertEqual(&interlock, PCF.getInterlock());
+  assertTrue(PCF.begin(0xFF));
+
+  PCF.write(0, LOW);
+  assertEqual(PCF8574_OK, PCF.lastError());
+  assertEqual(0xFE, sim.getLatch(0x20));
+
+  //  every write path is blocked, outputs unchanged
+  PCF.write(1, LOW);
+  assertEqual(PCF8574_INTERLOCK_ERROR, PCF.lastError());
+  PCF.toggle(1);
+  assertEqual(PCF8574_INTERLOCK_ERROR, PCF.lastError());
+  PCF.selectNone();
+  assertEqual(PCF8574_INTERLOCK_ERROR, PCF.lastError());
+  PCF.shiftLeft(1);
+  assertEqual(PCF8574_INTERLOCK_ERROR, PCF.lastError());
+  uint8_t values[2] = { 0xFF, 0xFC };
+  PCF.writeArray(values, 2);
+  assertEqual(PCF8574_INTERLOCK_ERROR, PCF.lastError());
+  assertEqual(0xFE, PCF.valueOut());
+  assertEqual(0xFE, sim.getLatch(0x20));
+  assertEqual(5, interlock.violations());
+
+  PCF.rotateLeft(1);
+  assertEqual(PCF8574_OK, PCF.lastError());
+  assertEqual(0xFD, sim.getLatch(0x20));
+
+  interlock.allowAll();
+  interlock.resetViolations();
+  PCF.write8(0x00);
+  assertEqual(0x00, PCF.valueOut());
+  assertEqual(0, interlock.violations());
+}
+
+
+unittest(test_selftest)
+{
+  PCF8574_Sim sim;
+  PCF8574 dev[4] = { PCF8574(0x20), PCF8574(0x21), PCF8574(0x22), PCF8574(0x23) };
+  PCF8574_Bank bank;
+  assertTrue(simBank(sim, dev, 4, bank));
+  dev[3].write8(0x5A);
+
+  PCF8574_FaultRule low    = { 0x20, PCF8574_FAULT_STUCK_LOW,  PCF8574_FAULT_ON_READ, 100, 0x01, 0, 0, PCF8574_SIM_FOREVER };
+  PCF8574_FaultRule bridge = { 0x21, PCF8574_FAULT_BRIDGE,     PCF8574_FAULT_ON_READ, 100, 0x0C, 0, 0, PCF8574_SIM_FOREVER };
+  PCF8574_FaultRule high   = { 0x22, PCF8574_FAULT_STUCK_HIGH, PCF8574_FAULT_ON_READ, 100, 0x80, 0, 0, PCF8574_SIM_FOREVER };
+  sim.addRule(low);
+  sim.addRule(bridge);
+  sim.addRule(high);
+
+  PCF8574_SelfTest test;
+  PCF8574_FaultMap map[4];
+  assertEqual(0x0007, test.run(bank, map));
+  assertEqual(10, test.steps());
+
+  assertEqual(0x01, map[0].stuckLow);
+  assertEqual(0x00, map[0].stuckHigh);
+  assertEqual(0x00, map[0].bridged[1]);
+  assertEqual(0x08, map[1].bridged[2]);
+  assertEqual(0x04, map[1].bridged[3]);
+  assertEqual(0x00, map[1].bridged[4]);
+  assertEqual(0x80, map[2].stuckHigh);
+  assertEqual(0x00, map[3].stuckLow | map[3].stuckHigh | map[3].bridged[0]);
+  assertEqual(PCF8574_OK, map[3].error);
+  //  outputs restored
+  assertEqual(0x5A, sim.getLatch(0x23));
+
+  //  single device, masked
+  test.setMask(0x0F);
+  assertTrue(test.run(&dev[2], map[0]));
+  assertEqual(6, test.steps());
+
+  PCF8574 PCF(0x30);
+  PCF.setSim(&sim);
+  assertFalse(test.run(&PCF, map[0]));
+  assertEqual(2, map[0].error);     //  Wire: address NACK
+}
+
+
+unittest(test_bank_refresh)
+{
+  PCF8574_VirtualClock clock(0);
+  PCF8574_setClock(&clock);
+  PCF8574_Sim sim;
+  PCF8574 dev[2] = { PCF8574(0x20), PCF8574(0x21) };
+  PCF8574_Bank bank;
+  simBank(sim, dev, 2, bank);
+  bank.setMaxAge(0xFFFFFFFF);   //  no read ahead
+  bank.read();
+  dev[0].write8(0x0F);
+  assertEqual(PCF8574_BANK_NONE, bank.service());
+
+  bank.setRefresh(1000, PCF8574_REFRESH_VERIFY);
+  assertEqual(1000, bank.getRefreshInterval());
+  assertEqual(PCF8574_REFRESH_VERIFY, bank.getRefreshMode());
+  clock.advance(1000);
+
+  //  supply dip resets the latch
+  uint8_t reset = 0xFF;
+  sim.write(0x20, &reset, 1);
+  assertEqual(0, bank.service());
+  assertEqual(1, bank.corrections());
+  assertEqual(0x0F, sim.getLatch(0x20));
+  assertEqual(1, bank.service());
+  assertEqual(1, bank.corrections());
+  assertEqual(PCF8574_BANK_NONE, bank.service());
+  assertEqual(2, bank.refreshCount());
+
+  //  output written HIGH flips LOW, pins 0..3 are outputs
+  dev[0].setButtonMask(0xF0);
+  clock.advance(1000);
+  uint8_t flip = 0x0E;
+  sim.write(0x20, &flip, 1);
+  assertEqual(0, bank.service());
+  assertEqual(2, bank.corrections());
+  assertEqual(0x0F, sim.getLatch(0x20));
+  assertEqual(1, bank.service());
+
+  //  a button held LOW is not an output error
+  sim.setInput(0x20, 0x7F);
+  clock.advance(1000);
+  assertEqual(0, bank.service());
+  assertEqual(1, bank.service());
+  assertEqual(2, bank.corrections());
+  assertEqual(6, bank.refreshCount());
+  sim.setInput(0x20, 0xFF);
+
+  //  bus share, every transaction takes 100 us
+  PCF8574_FaultRule stretch = { PCF8574_SIM_ALL, PCF8574_FAULT_STRETCH, PCF8574_FAULT_ON_ALL, 100, 0, 100, 0, PCF8574_SIM_FOREVER };
+  sim.addRule(stretch);
+  bank.setBusShare(10);
+  assertEqual(10, bank.getBusShare());
+  bank.setRefresh(1);
+  clock.advance(1);
+  assertEqual(0, bank.service());
+  assertEqual(PCF8574_BANK_NONE, bank.service());   //  hold 1000 us
+  clock.advance(899);
+  assertEqual(PCF8574_BANK_NONE, bank.service());
+  clock.advance(1);
+  assertEqual(1, bank.service());
+  assertEqual(8, bank.refreshCount());
+  PCF8574_setClock(nullptr);
+}
+
+
+unittest(test_modbus)
+{
+  //  spec example, read coils 20..56 of slave 17
+  uint8_t example[6] = { 0x11, 0x01, 0x00, 0x13, 0x00, 0x25 };
+  assertEqual(0x840E, PCF8574_Modbus::crc16(example, 6));
+
+  PCF8574_Sim sim;
+  PCF8574 dev[2] = { PCF8574(0x20), PCF8574(0x21) };
+  PCF8574_Bank bank;
+  simBank(sim, dev, 2, bank);
+  dev[0].write8(0x00);
+  dev[1].write8(0x00);
+
+  PCF8574_Modbus modbus(&bank, 0x11);
+  uint8_t request[16];
+  uint8_t response[PCF8574_MODBUS_BUFFER];
+  uint16_t crc;
+
+  //  write multiple coils 4..11 = 0xA5, spans both devices
+  uint8_t wr[8] = { 0x11, 0x0F, 0x00, 0x04, 0x00, 0x08, 0x01, 0xA5 };
+  memcpy(request, wr, 8);
+  appendCRC(request, 8);
+  uint32_t n = sim.transactions(0x20) + sim.transactions(0x21);
+  assertEqual(8, modbus.process(request, 10, response));
+  assertEqual(0x0F, response[1]);
+  assertEqual(0x08, response[5]);
+  assertEqual(n + 2, sim.transactions(0x20) + sim.transactions(0x21));
+  assertEqual(0x50, sim.getLatch(0x20));
+  assertEqual(0x0A, sim.getLatch(0x21));
+
+  //  read coils 0..15
+  uint8_t rd[6] = { 0x11, 0x01, 0x00, 0x00, 0x00, 0x10 };
+  memcpy(request, rd, 6);
+  appendCRC(request, 6);
+  assertEqual(7, modbus.process(request, 8, response));
+  assertEqual(2, response[2]);
+  assertEqual(0x50, response[3]);
+  assertEqual(0x0A, response[4]);
+  crc = PCF8574_Modbus::crc16(response, 5);
+  assertEqual(crc & 0xFF, response[5]);
+
+  //  read discrete inputs 6..9, quasi bidirectional, external LOW wins
+  sim.setInput(0x20, 0x7F);
+  request[1] = 0x02;
+  request[3] = 0x06;
+  request[5] = 0x04;
+  appendCRC(request, 6);
+  assertEqual(6, modbus.process(request, 8, response));
+  assertEqual(0x09, response[3] & 0x0F);  //  pin 6 = 1, 7 = 0, 8 = 0, 9 = 1
+
+  //  write single coil 7 ON, invalid value, out of range
+  uint8_t wc[6] = { 0x11, 0x05, 0x00, 0x07, 0xFF, 0x00 };
+  memcpy(request, wc, 6);
+  appendCRC(request, 6);
+  assertEqual(8, modbus.process(request, 8, response));
+  assertEqual(0xD0, sim.getLatch(0x20));
+  request[4] = 0x12;
+  appendCRC(request, 6);
+  assertEqual(5, modbus.process(request, 8, response));
+  assertEqual(0x85, response[1]);
+  assertEqual(PCF8574_MB_ILLEGAL_VALUE, response[2]);
+  request[3] = 0x10;
+  request[4] = 0xFF;
+  appendCRC(request, 6);
+  assertEqual(5, modbus.process(request, 8, response));
+  assertEqual(PCF8574_MB_ILLEGAL_ADDRESS, response[2]);
+
+  //  other slave, bad CRC, unknown function
+  request[0] = 0x12;
+  assertEqual(0, modbus.process(request, 8, response));
+  assertEqual(1, modbus.crcErrors());
+  request[0] = 0x11;
+  request[1] = 0x03;
+  appendCRC(request, 6);
+  assertEqual(5, modbus.process(request, 8, response));
+  assertEqual(PCF8574_MB_ILLEGAL_FUNCTION, response[2]);
+  assertEqual(3, modbus.exceptions());
+  assertEqual(7, modbus.requests());
+
+  //  truncated write frames, the length is checked before the operands
+  uint8_t fc05[4] = { 0x11, PCF8574_MB_WRITE_COIL, 0, 0 };
+  appendCRC(fc05, 2);
+  assertEqual(5, modbus.process(fc05, 4, response));
+  assertEqual(PCF8574_MB_ILLEGAL_VALUE, response[2]);
+  uint8_t fc0f[8] = { 0x11, PCF8574_MB_WRITE_COILS, 0x00, 0x00, 0x00, 0x08, 0, 0 };
+  appendCRC(fc0f, 6);
+  assertEqual(5, modbus.process(fc0f, 8, response));
+  assertEqual(PCF8574_MB_ILLEGAL_VALUE, response[2]);
+  assertEqual(5, modbus.exceptions());
+}
+
+
+unittest(test_bridge)
+{
+  PCF8574_Sim sim;
+  PCF8574 dev[2] = { PCF8574(0x20), PCF8574(0x21) };
+  PCF8574_Bank bank;
+  simBank(sim, dev, 2, bank);
+
+  PCF8574_Bridge bridge(&bank);
+  PCF8574_BridgeRequest request;
+  uint8_t response[PCF8574_BRIDGE_BUFFER];
+
+  //  three updates of device 0 coalesce into one write
+  request.clear();
+  assertTrue(request.write(0, 0x00));
+  assertTrue(request.mask(0, 0x0F, 0x05));
+  assertTrue(request.mask(0, 0xF0, 0xA0));
+  assertTrue(request.read(1));
+  assertTrue(request.write(1, 0x3C));
+  uint8_t len = request.finish();
+  uint8_t n = bridge.process(request.frame(), len, response);
+  assertEqual(7, n);
+  assertTrue(PCF8574_BridgeRequest::check(response, n, request.sequence()));
+  assertEqual(PCF8574_BR_OK, response[3]);
+  assertEqual(0xFF, response[4]);
+  assertEqual(3, bridge.transactions());
+  assertEqual(0xA5, sim.getLatch(0x20));
+  assertEqual(0x3C, sim.getLatch(0x21));
+  uint8_t in[2], out[2];
+  assertTrue(bank.snapshot(in, out));
+  assertEqual(0xA5, out[0]);
+
+  //  a read flushes the pending write first
+  request.clear();
+  request.write(0, 0x0F);
+  request.read(0);
+  uint8_t values[3] = { 0x01, 0x02, 0x04 };
+  assertTrue(request.stream(1, values, 3));
+  request.readAll();
+  len = request.finish();
+  n = bridge.process(request.frame(), len, response);
+  assertEqual(9, n);
+  assertEqual(0x0F, response[4]);
+  assertEqual(0x0F, response[5]);
+  assertEqual(0x04, response[6]);
+  assertEqual(5, bridge.transactions());
+
+  //  bus order is the order of the request
+  request.clear();
+  request.write(0, 0x00);
+  request.read(1);
+  len = request.finish();
+  n = bridge.process(request.frame(), len, response);
+  assertEqual(PCF8574_BR_OK, response[3]);
+  assertEqual(2, bridge.transactions());
+  assertEqual(0x00, sim.getLatch(0x20));
+  assertTrue(sim.lastTransaction(0x20) < sim.lastTransaction(0x21));
+
+  //  only adjacent updates of the same device are coalesced
+  request.clear();
+  request.write(0, 0x11);
+  request.mask(0, 0xF0, 0x20);
+  request.write(1, 0x33);
+  request.write(0, 0x44);
+  len = request.finish();
+  uint32_t before = sim.transactions(0x20);
+  bridge.process(request.frame(), len, response);
+  assertEqual(3, bridge.transactions());
+  assertEqual(before + 2, sim.transactions(0x20));
+  assertEqual(0x44, sim.getLatch(0x20));
+  assertTrue(sim.lastTransaction(0x21) < sim.lastTransaction(0x20));
+
+  //  bad device, nothing executed
+  request.clear();
+  request.write(0, 0x00);
+  request.read(2);
+  len = request.finish();
+  n = bridge.process(request.frame(), len, response);
+  assertEqual(6, n);
+  assertEqual(PCF8574_BR_BAD_REQUEST, response[3]);
+  assertEqual(0x44, sim.getLatch(0x20));
+
+  //  bad CRC, no response
+  uint8_t frame[PCF8574_BRIDGE_BUFFER];
+  memcpy(frame, request.frame(), len);
+  frame[3] ^= 0x01;
+  assertEqual(0, bridge.process(frame, len, response));
+  assertEqual(1, bridge.crcErrors());
+  assertEqual(5, bridge.requests());
+
+  //  I2C error stops execution
+  PCF8574_FaultRule nack = { 0x21, PCF8574_FAULT_NACK, PCF8574_FAULT_ON_ALL, 100, 0, 0, 0, PCF8574_SIM_FOREVER };
+  sim.addRule(nack);
+  request.clear();
+  request.readAll();
+  len = request.finish();
+  n = bridge.process(request.frame(), len, response);
+  assertEqual(PCF8574_BR_IO_ERROR, response[3]);
+  assertEqual(8, n);   //  result of device 0 and 1
+}
+
+
+PCF8574_VirtualClock scanClock(0);
+
+void scanLogic(const uint8_t * inputs, uint8_t * outputs)
+{
+  outputs[1] = inputs[0] | 0x0F;   //  copy upper nibble
+  scanClock.advance(50);           //  CPU time
+}
+
+
+unittest(test_scan_cycle)
+{
+  PCF8574_setClock(&scanClock);
+  PCF8574_Sim sim;
+  PCF8574 dev[2] = { PCF8574(0x20), PCF8574(0x21) };
+  PCF8574_Bank bank;
+  simBank(sim, dev, 2, bank);
+  PCF8574_FaultRule stretch = { PCF8574_SIM_ALL, PCF8574_FAULT_STRETCH, PCF8574_FAULT_ON_ALL, 100, 0, 100, 0, PCF8574_SIM_FOREVER };
+  sim.addRule(stretch);
+
+  PCF8574_ScanCycle plc(&bank, scanLogic);
+  plc.begin();
+  plc.setWatchdog(300);
+
+  //  read 2 x 100, logic 50, no output change
+  assertEqual(0, plc.scan());
+  assertEqual(250, plc.lastCycle());
+  assertEqual(0, plc.overruns());
+  assertEqual(0xFF, plc.outputs()[1]);
+
+  //  read 2 x 100, logic 50, 1 write 100
+  sim.setInput(0x20, 0x3F);
+  assertEqual(0, plc.scan());
+  assertEqual(0x3F, plc.inputs()[0]);
+  assertEqual(0x3F, sim.getLatch(0x21));
+  assertEqual(350, plc.lastCycle());
+  assertTrue(plc.lastOverrun());
+  assertEqual(1, plc.overruns());
+
+  assertEqual(2, plc.cycles());
+  assertEqual(250, plc.minCycle());
+  assertEqual(350, plc.maxCycle());
+  assertEqualFloat(300, plc.avgCycle(), 0.01);
+  assertEqualFloat((80.0 + 85.714) / 2, plc.busShare(), 0.01);
+
+  //  periodic
+  plc.setPeriod(1000);
+  assertFalse(plc.update());
+  scanClock.advance(1000);
+  assertTrue(plc.update());
+  assertEqual(3, plc.cycles());
+  plc.resetStatistics();
+  assertEqual(0, plc.cycles());
+  PCF8574_setClock(nullptr);
+}
+
+
+unittest(test_logic)
+{
+  PCF8574_Logic logic;
+  assertTrue(logic.addRule(1, 3, "0.1 & !0.5"));
+  assertTrue(logic.addRule(1, 4, "0.0 ^ 0.1"));
+  assertTrue(logic.addRule(1, 5, "!(0.2 | 0.3) | 0.7 & 0.6"));
+  assertTrue(logic.addRule(1, 6, "0.4 & !0.4"));              //  always false
+  assertTrue(logic.addRule(1, 7, "(0.0 | 0.1) & (0.2 | 0.3)"));
+  assertEqual(5, logic.rules());
+
+  for (int v = 0; v < 256; v++)
+  {
+    uint8_t in[2] = { (uint8_t)v, 0x00 };
+    uint8_t out[2] = { 0x00, 0x00 };
+    logic.evaluate(in, out);
+    bool b[8];
+    for (int i = 0; i < 8; i++) b[i] = (v >> i) & 1;
+    uint8_t expect = 0;
+    if (b[1] && !b[5]) expect |= 0x08;
+    if (b[0] != b[1]) expect |= 0x10;
+    if (!(b[2] || b[3]) || (b[7] && b[6])) expect |= 0x20;
+    if ((b[0] || b[1]) && (b[2] || b[3])) expect |= 0x80;
+    assertEqual(expect, out[1]);
+  }
+
+  //  multi device, a pin is 5 bytes, an operator 1, the output 3
+  logic.clear();
+  assertTrue(logic.addRule(0, 0, "1.0 & 1.1 & !1.2 & 2.7"));
+  assertEqual(4 * 5 + 4 + 3, logic.size());
+  uint8_t in[3] = { 0x00, 0x03, 0x80 };
+  uint8_t out[3] = { 0x00, 0x00, 0x00 };
+  logic.evaluate(in, out);
+  assertEqual(0x01, out[0]);
+  in[1] = 0x07;
+  logic.evaluate(in, out);
+  assertEqual(0x00, out[0]);
+
+  //  XOR is native, no expansion
+  logic.clear();
+  assertTrue(logic.addRule(1, 0, "0.0 ^ 0.1 ^ 0.2 ^ 0.3"));
+  assertTrue(logic.addRule(1, 1, "(0.0|0.1)&(0.2|0.3)&(0.4|0.5)&(0.6|0.7)"));
+  assertTrue(logic.addRule(1, 2, "0.0 ^ 0.1 ^ 0.2 ^ 0.3 ^ 0.4 ^ 0.5 ^ 0.6 ^ 0.7"));
+  for (int v = 0; v < 256; v++)
+  {
+    uint8_t in[2] = { (uint8_t)v, 0x00 };
+    uint8_t out[2] = { 0x00, 0x00 };
+    logic.evaluate(in, out);
+    bool b[8];
+    for (int i = 0; i < 8; i++) b[i] = (v >> i) & 1;
+    uint8_t expect = 0;
+    if (b[0] ^ b[1] ^ b[2] ^ b[3]) expect |= 0x01;
+    if ((b[0] || b[1]) && (b[2] || b[3]) && (b[4] || b[5]) && (b[6] || b[7])) expect |= 0x02;
+    if (b[0] ^ b[1] ^ b[2] ^ b[3] ^ b[4] ^ b[5] ^ b[6] ^ b[7]) expect |= 0x04;
+    assertEqual(expect, out[1]);
+  }
+
+  //  bit sliced, rules with the same structure share the operations
+  logic.clear();
+  for (int pin = 0; pin < 8; pin++)
+  {
+    char rule[16];
+    sprintf(rule, "0.%d & !1.%d", pin, pin);
+    assertTrue(logic.addRule(3, pin, rule));
+  }
+  assertEqual(8, logic.rules());
+  assertEqual(5 + 5 + 1 + 1 + 3, logic.size());
+  //  input pins rotate into the lane of the output pin
+  assertTrue(logic.addRule(2, 0, "0.1 ^ 1.7"));
+  assertTrue(logic.addRule(2, 1, "0.3 ^ 1.0"));
+  assertEqual(15 + 14 + 3, logic.size());     //  1.7 => 2.0 and 1.0 => 2.1 share an entry
+  for (int v = 0; v < 256; v++)
+  {
+    uint8_t in[2] = { (uint8_t)v, (uint8_t)(v * 37 + 0x5A) };
+    uint8_t out[4] = { 0x00, 0x00, 0x00, 0x00 };
+    logic.evaluate(in, out);
+    assertEqual(in[0] & ~in[1], out[3]);
+    uint8_t expect = (((in[0] >> 1) ^ (in[1] >> 7)) & 1) | ((((in[0] >> 3) ^ in[1]) & 1) << 1);
+    assertEqual(expect, out[2]);
+  }
+
+  //  the last rule for an output pin wins, also if an earlier one has its structure
+  logic.clear();
+  assertTrue(logic.addRule(1, 0, "0.0 & 0.1"));
+  assertTrue(logic.addRule(1, 0, "0.2"));
+  assertTrue(logic.addRule(1, 1, "0.3 & 0.4"));     //  shares the first
+  assertTrue(logic.addRule(1, 0, "0.5 & 0.6"));
+  for (int v = 0; v < 256; v++)
+  {
+    uint8_t in[2] = { (uint8_t)v, 0x00 };
+    uint8_t out[2] = { 0x00, 0x00 };
+    logic.evaluate(in, out);
+    uint8_t expect = ((v >> 5) & (v >> 6) & 1) | (((v >> 3) & (v >> 4) & 1) << 1);
+    assertEqual(expect, out[1]);
+  }
+
+  //  errors
+  assertFalse(logic.addRule(0, 0, "0.1 & "));
+  assertEqual(PCF8574_LOGIC_SYNTAX, logic.lastError());
+  assertFalse(logic.addRule(0, 0, "0.8"));
+  assertEqual(PCF8574_LOGIC_SYNTAX, logic.lastError());
+  assertEqual(1, logic.errorPosition());
+  //  PCF8574_LOGIC_TOKENS (32) pins + operators
+  assertFalse(logic.addRule(0, 0, "0.0|0.1|0.2|0.3|0.4|0.5|0.6|0.7|1.0|1.1|1.2|1.3|1.4|1.5|1.6|1.7|2.0"));
+  assertEqual(PCF8574_LOGIC_COMPLEX, logic.lastError());
+  //  PCF8574_LOGIC_STACK (8) words
+  assertFalse(logic.addRule(0, 0, "0.0&(0.1&(0.2&(0.3&(0.4&(0.5&(0.6&(0.7&1.0)))))))"));
+  assertEqual(PCF8574_LOGIC_COMPLEX, logic.lastError());
+  assertEqual(4, logic.rules());
+
+  //  nesting is limited
+  char deep[2 * PCF8574_LOGIC_DEPTH + 8];
+  uint8_t n = 0;
+  for (uint8_t i = 0; i <= PCF8574_LOGIC_DEPTH; i++) deep[n++] = '!';
+  strcpy(deep + n, "0.1");
+  assertFalse(logic.addRule(0, 1, deep));
+  assertEqual(PCF8574_LOGIC_NESTING, logic.lastError());
+  assertEqual(PCF8574_LOGIC_DEPTH, logic.errorPosition());
+  assertTrue(logic.addRule(0, 1, deep + 1));
+  n = 0;
+  for (uint8_t i = 0; i < PCF8574_LOGIC_DEPTH; i++) deep[n++] = '(';
+  strcpy(deep + n, "0.1");
+  n += 3;
+  for (uint8_t i = 0; i < PCF8574_LOGIC_DEPTH; i++) deep[n++] = ')';
+  deep[n] = 0;
+  assertTrue(logic.addRule(0, 2, deep));
+
+  //  error before any expression is parsed
+  PCF8574_Logic fresh;
+  assertFalse(fresh.addRule(PCF8574_BANK_SIZE, 0, "0.1"));
+  assertEqual(PCF8574_LOGIC_SYNTAX, fresh.lastError());
+  assertEqual(0, fresh.errorPosition());
+}
+
+
+unittest(test_vm)
+{
+  PCF8574_VirtualClock clock(0);
+  PCF8574_setClock(&clock);
+  PCF8574_Sim sim;
+  PCF8574 dev[2] = { PCF8574(0x20), PCF8574(0x21) };
+  PCF8574_Bank bank;
+  simBank(sim, dev, 2, bank);
+  //  every transaction takes 100 us
+  PCF8574_FaultRule stretch = { PCF8574_SIM_ALL, PCF8574_FAULT_STRETCH, PCF8574_FAULT_ON_ALL, 100, 0, 100, 0, PCF8574_SIM_FOREVER };
+  sim.addRule(stretch);
+
+  PCF8574_VM vm(&bank);
+  sim.setInput(0x21, 0xFE);
+  const uint8_t program[] =
+  {
+    PCF8574_VM_WRITE, 0, 0xF0,
+    PCF8574_VM_WAIT,  1, 0x01, 0x00, 0x0A, 0x00,   //  1.0 LOW, 10 ms
+    PCF8574_VM_LOOP,  3,
+      PCF8574_VM_PULSE, 0, 0x01, 0xE8, 0x03,       //  1000 us
+      PCF8574_VM_READ,  0,
+    PCF8574_VM_NEXT,
+    PCF8574_VM_MASK,  0, 0x0F, 0x05,
+    PCF8574_VM_DELAY_MS, 0x02, 0x00,
+    PCF8574_VM_READ,  1,
+    PCF8574_VM_END,
+    PCF8574_VM_WRITE, 0, 0x00                      //  not executed
+  };
+  assertEqual(PCF8574_VM_OK, vm.run(program, sizeof(program)));
+  assertEqual(4, vm.resultCount());
+  assertEqual(0xF0, vm.results()[0]);
+  assertEqual(0xFE, vm.results()[3]);
+  assertEqual(0xF5, sim.getLatch(0x20));
+  //  write, wait, 3 x (pulse 2 + read), mask, read
+  assertEqual(13, vm.transactions());
+  //  bus time, one WAIT poll, pulses, delay
+  assertEqual(13 * 100 + PCF8574_VM_POLL_US + 3 * 1000 + 2000, PCF8574_micros());
+
+  //  timeout
+  const uint8_t wait[] = { PCF8574_VM_WAIT, 1, 0x02, 0x00, 0x01, 0x00 };
+  assertEqual(PCF8574_VM_TIMEOUT, vm.run(wait, sizeof(wait)));
+  //  every poll advances the virtual clock, also without bus time
+  sim.clearRules();
+  uint32_t start = PCF8574_micros();
+  assertEqual(PCF8574_VM_TIMEOUT, vm.run(wait, sizeof(wait)));
+  //  1 ms timeout, millis granularity
+  assertLessOrEqual(PCF8574_micros() - start, 2000);
+  assertMore(vm.transactions(), 1);
+  sim.addRule(stretch);
+  //  bad device, bad loop, truncated
+  const uint8_t bad[] = { PCF8574_VM_READ, 0, PCF8574_VM_READ, 2 };
+  assertEqual(PCF8574_VM_BAD_CODE, vm.run(bad, sizeof(bad)));
+  assertEqual(2, vm.errorAddress());
+  assertEqual(1, vm.resultCount());
+  const uint8_t next[] = { PCF8574_VM_NEXT };
+  assertEqual(PCF8574_VM_BAD_CODE, vm.run(next, sizeof(next)));
+  assertEqual(PCF8574_VM_BAD_CODE, vm.run(program, 4));
+
+  //  through the bridge, results in one reply
+  PCF8574_Bridge bridge(&bank);
+  PCF8574_BridgeRequest request;
+  uint8_t response[PCF8574_BRIDGE_BUFFER];
+  request.clear();
+  request.write(1, 0x7F);
+  assertTrue(request.run(program, sizeof(program)));
+  request.read(0);
+  uint8_t len = request.finish();
+  uint8_t n = bridge.process(request.frame(), len, response);
+  assertEqual(PCF8574_BR_OK, response[3]);
+  assertEqual(11, n);
+  assertEqual(0x7E, response[7]);    //  1.0 LOW, 1.7 written LOW
+  assertEqual(0xF5, response[8]);
+
+  //  RUN length past the end of the frame, e.g. 0xFE, executes nothing
+  uint8_t frame[7] = { PCF8574_BRIDGE_SYNC, 0x03, 0x01, PCF8574_BR_RUN, 0xFE, 0, 0 };
+  appendCRC(&frame[1], 4);
+  n = bridge.process(frame, 7, response);
+  assertEqual(6, n);
+  assertEqual(PCF8574_BR_BAD_REQUEST, response[3]);
+  frame[4] = 0x01;
+  appendCRC(&frame[1], 4);
+  assertEqual(PCF8574_BR_BAD_REQUEST, bridge.process(frame, 7, response) ? response[3] : 0xFF);
+
+  //  16 bit operands >= 0x8000 are unsigned, 0x9C40 == 40000
+  const uint8_t longDelay[] =
+  {
+    PCF8574_VM_DELAY,    0x40, 0x9C,
+    PCF8574_VM_DELAY_MS, 0x40, 0x9C,
+    PCF8574_VM_PULSE,    0, 0x01, 0x40, 0x9C
+  };
+  uint32_t t0 = PCF8574_micros();
+  assertEqual(PCF8574_VM_OK, vm.run(longDelay, sizeof(longDelay)));
+  assertEqual(40000UL + 40000000UL + 40000UL + 2 * 100, PCF8574_micros() - t0);
+
+  //  a looping RUN has more than 255 transactions
+  const uint8_t pulses[] = { PCF8574_VM_LOOP, 150, PCF8574_VM_PULSE, 0, 0x01, 0x00, 0x00, PCF8574_VM_NEXT };
+  request.clear();
+  assertTrue(request.run(pulses, sizeof(pulses)));
+  len = request.finish();
+  bridge.process(request.frame(), len, response);
+  assertEqual(PCF8574_BR_OK, response[3]);
+  assertEqual(300, bridge.transactions());
+  PCF8574_setClock(nullptr);
+}
+
+
+uint8_t  pipePin = 0xFF;
+bool     pipeRising = false;
+uint8_t  pipeCalls = 0;
+
+void pipeKey(uint8_t pin, bool rising)
+{
+  pipePin = pin;
+  pipeRising = rising;
+  pipeCalls++;
+}
+
+
+unittest(test_pipeline)
+{
+  PCF8574_Sim sim;
+  sim.addDevice(0x20);
+  sim.addDevice(0x21);
+  PCF8574 PCF(0x20);
+  PCF.setSim(&sim);
+  PCF.begin();
+
+  PCF8574_Pipeline<PCF8574_PipeSource<PCF8574>,
+                   PCF8574_PipeInvert<0xFF>,
+                   PCF8574_PipeDebounce,
+                   PCF8574_PipeEdges,
+                   PCF8574_PipeDispatch<pipeKey> > keys(PCF);
+
+  assertEqual(0x00, keys.update());
+  assertEqual(0, pipeCalls);
+
+  //  button on pin 2 pressed, 4 equal samples needed
+  sim.setInput(0x20, 0xFB);
+  for (int i = 0; i < 3; i++) assertEqual(0x00, keys.update());
+  assertEqual(0x04, keys.update());
+  assertEqual(0x04, keys.rising());
+  assertEqual(1, pipeCalls);
+  assertEqual(2, pipePin);
+  assertTrue(pipeRising);
+
+  //  bounce is filtered
+  sim.setInput(0x20, 0xFF);
+  keys.update();
+  sim.setInput(0x20, 0xFB);
+  keys.update();
+  assertEqual(1, pipeCalls);
+
+  //  release
+  sim.setInput(0x20, 0xFF);
+  for (int i = 0; i < 4; i++) keys.update();
+  assertEqual(0x00, keys.value());
+  assertEqual(0x04, keys.falling());
+  assertEqual(2, pipeCalls);
+  assertFalse(pipeRising);
+
+  //  bank source, 16 bit word
+  PCF8574 PCF2(0x21);
+  PCF2.setSim(&sim);
+  PCF8574_Bank bank;
+  bank.add(&PCF);
+  bank.add(&PCF2);
+  bank.begin();
+  PCF8574_Pipeline<PCF8574_PipeBankSource<2>, PCF8574_PipeEdges> edges(bank);
+  sim.setInput(0x21, 0x7F);
+  assertEqual(0x7FFF, edges.update());
+  assertEqual(0x7FFF, edges.rising());
+  assertEqual(0x7FFF, edges.update());
+  assertEqual(0x0000, edges.rising());
+}
+
+
 unittest_main()
 
 